@@ -0,0 +1,114 @@
+#include "benchmark.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+BenchmarkRunner::BenchmarkRunner(int argc, char* argv[]) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string arg = argv[i];
+    if (arg == "--filter") {
+      filter_ = argv[i + 1];
+    } else if (arg == "--json") {
+      json_path_ = argv[i + 1];
+    } else if (arg == "--min-time") {
+      min_time_ = std::atof(argv[i + 1]);
+    } else if (arg == "--max-rows") {
+      max_rows_ = std::strtoull(argv[i + 1], nullptr, 10);
+    } else {
+      std::cerr << "Unknown option: " << arg << "\n";
+    }
+  }
+
+  std::cout << std::left << std::setw(48) << "Benchmark" << std::right
+            << std::setw(16) << "Time, ns" << std::setw(12) << "Iterations"
+            << std::setw(16) << "Items/s" << "\n";
+}
+
+bool BenchmarkRunner::IsEnabled(const std::string& name) const {
+  return name.find(filter_) != std::string::npos;
+}
+
+size_t BenchmarkRunner::GetMaxRows() const { return max_rows_; }
+
+void BenchmarkRunner::Run(const std::string& name, size_t items_per_iteration,
+                          const std::function<void()>& iteration) {
+  if (!IsEnabled(name)) {
+    return;
+  }
+
+  using Clock = std::chrono::steady_clock;
+
+  // warm up caches and lazily built state
+  iteration();
+
+  size_t iterations = 0;
+  std::chrono::duration<double> elapsed(0.0);
+  size_t batch = 1;
+  while (elapsed.count() < min_time_) {
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < batch; ++i) {
+      iteration();
+    }
+    elapsed += Clock::now() - start;
+    iterations += batch;
+    batch *= 2;
+  }
+
+  double seconds_per_iteration = elapsed.count() / iterations;
+  Result result{name, iterations, seconds_per_iteration * 1e9,
+                items_per_iteration / seconds_per_iteration};
+  results_.push_back(result);
+
+  std::cout << std::left << std::setw(48) << result.name << std::right
+            << std::setw(16) << std::fixed << std::setprecision(0)
+            << result.real_time_ns << std::setw(12) << result.iterations
+            << std::setw(16) << std::scientific << std::setprecision(3)
+            << result.items_per_second << std::endl;
+}
+
+bool BenchmarkRunner::Finish() const {
+  if (json_path_.empty()) {
+    return true;
+  }
+
+  std::ofstream ofs(json_path_);
+  if (!ofs.is_open()) {
+    std::cerr << "Unable to open file: " << json_path_ << "\n";
+    return false;
+  }
+
+  std::time_t now = std::time(nullptr);
+  char date[32];
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+  ofs << "{\n  \"context\": {\n"
+      << "    \"date\": \"" << date << "\",\n"
+      << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+      << "    \"library_build_type\": \"release\"\n"
+#else
+      << "    \"library_build_type\": \"debug\"\n"
+#endif
+      << "  },\n  \"benchmarks\": [";
+  for (size_t i = 0; i < results_.size(); ++i) {
+    const Result& result = results_[i];
+    ofs << (i == 0 ? "\n" : ",\n") << "    {\n"
+        << "      \"name\": \"" << result.name << "\",\n"
+        << "      \"run_type\": \"iteration\",\n"
+        << "      \"iterations\": " << result.iterations << ",\n"
+        << std::setprecision(17) << "      \"real_time\": "
+        << result.real_time_ns << ",\n"
+        << "      \"cpu_time\": " << result.real_time_ns << ",\n"
+        << "      \"time_unit\": \"ns\",\n"
+        << "      \"items_per_second\": " << result.items_per_second << "\n"
+        << "    }";
+  }
+  ofs << "\n  ]\n}\n";
+
+  return ofs.good();
+}
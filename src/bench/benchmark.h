@@ -0,0 +1,50 @@
+#ifndef ALGORITHMIC_TRADING_BENCH_BENCHMARK_H
+#define ALGORITHMIC_TRADING_BENCH_BENCHMARK_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal benchmark runner. Every case is timed over enough iterations to
+// fill the minimum measuring time, and results can be written as JSON in the
+// layout of Google Benchmark's --benchmark_format=json, so the usual
+// comparison tooling can read it.
+class BenchmarkRunner {
+ public:
+  struct Result {
+    std::string name;
+    size_t iterations;
+    double real_time_ns;  // per iteration
+    double items_per_second;
+  };
+
+  BenchmarkRunner(int argc, char* argv[]);
+
+  // whether the case passes --filter, to skip preparing its data otherwise
+  bool IsEnabled(const std::string& name) const;
+  size_t GetMaxRows() const;
+
+  void Run(const std::string& name, size_t items_per_iteration,
+           const std::function<void()>& iteration);
+  bool Finish() const;
+
+ private:
+  double min_time_ = 0.5;  // seconds
+  size_t max_rows_ = 10'000'000;
+  std::string filter_;
+  std::string json_path_;
+  std::vector<Result> results_;
+};
+
+// keeps the compiler from discarding a computed value
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+#endif  // ALGORITHMIC_TRADING_BENCH_BENCHMARK_H
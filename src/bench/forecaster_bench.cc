@@ -0,0 +1,278 @@
+// Benchmarks of the forecasting hot paths on synthetic random-walk series.
+//
+//   forecast_bench [--filter TEXT] [--json FILE] [--min-time SECONDS]
+//                  [--max-rows N]
+//
+// LoadData and the StockForecaster query cases go through a generated CSV
+// file of daily rows from 1900. Dates are parsed with four-digit years, so
+// these cases stop at 1M rows; the fitting cases run up to 10M rows, the
+// model selection up to 100K. The simulation runs a month of daily steps
+// from a year of rows, per path and step.
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "cubic_spline.h"
+#include "least_squares_polynomial.h"
+#include "model_selector.h"
+#include "price_simulator.h"
+#include "recursive_least_squares.h"
+#include "stockforecaster.h"
+#include "time_point.h"
+#include "time_series.h"
+
+namespace fs = std::filesystem;
+
+const time_t kSecondsPerDay = 24 * 60 * 60;
+const size_t kMaxCsvRows = 1'000'000;
+const size_t kQueriesCount = 1000;
+const size_t kMaxSelectionRows = 100'000;
+
+TimeSeries MakeRandomWalk(size_t rows_count, time_t first_date) {
+  std::mt19937_64 generator(42);
+  std::normal_distribution<double> step(0.0, 1.0);
+
+  TimeSeries series;
+  series.Reserve(rows_count);
+  double price = 100.0;
+  for (size_t i = 0; i < rows_count; ++i) {
+    series.Append(first_date + i * kSecondsPerDay, price);
+    price += step(generator);
+  }
+
+  return series;
+}
+
+fs::path WriteCsv(const TimeSeries& series) {
+  fs::path path = fs::temp_directory_path() /
+                  ("forecast_bench_" + std::to_string(series.size()) + ".csv");
+  std::ofstream ofs(path);
+  ofs << "Date,Close\n";
+
+  char line[64];
+  for (size_t i = 0; i < series.size(); ++i) {
+    int year;
+    unsigned month, day;
+    TimePoint::CivilFromDays(series.Dates()[i] / kSecondsPerDay, year, month,
+                             day);
+    int length = std::snprintf(line, sizeof(line), "%04d-%02u-%02u,%.6f\n",
+                               year, month, day, series.Prices()[i]);
+    ofs.write(line, length);
+  }
+
+  return path;
+}
+
+void BenchmarkFitting(BenchmarkRunner& runner, size_t rows_count) {
+  std::string size = "/" + std::to_string(rows_count);
+  TimeSeries series = MakeRandomWalk(rows_count, 0);
+
+  // DefineInterpolationCoefficients with the tridiagonal solve
+  runner.Run("BM_CubicSplineFit" + size, rows_count,
+             [&series]() { DoNotOptimize(CubicSpline(series)); });
+
+  // one more bar on top of the fitted series, refitting only the tail
+  CubicSpline spline(series);
+  time_t date = series.Dates().back();
+  runner.Run("BM_CubicSplineAppend" + size, 1, [&spline, &date]() {
+    date += kSecondsPerDay;
+    spline.Append(date, 100.0);
+  });
+
+  // DefineApproximationCoefficients
+  for (int degree : {3, 10}) {
+    runner.Run("BM_LeastSquaresFit" + size + "/" + std::to_string(degree),
+               rows_count, [&series, degree]() {
+                 DoNotOptimize(LeastSquaresPolynomial(series, degree));
+               });
+  }
+}
+
+void BenchmarkSelection(BenchmarkRunner& runner, size_t rows_count) {
+  std::string name = "BM_ModelSelection/" + std::to_string(rows_count);
+  if (rows_count > kMaxSelectionRows || !runner.IsEnabled(name)) {
+    return;
+  }
+
+  // the default grid of degrees 1-6, windows 60-250 and horizons 1 and 5
+  TimeSeries series = MakeRandomWalk(rows_count, 0);
+  ModelSelectionGrid grid;
+  ThreadPool pool;
+  ModelSelector selector;
+  if (!selector.Select(series, grid, pool)) {
+    return;  // fewer rows than the largest window and horizon
+  }
+
+  runner.Run(name, rows_count, [&series, &grid, &pool, &selector]() {
+    selector.Select(series, grid, pool);
+  });
+}
+
+void BenchmarkStreaming(BenchmarkRunner& runner) {
+  TimeSeries series = MakeRandomWalk(1000, 0);
+
+  // one more bar into a trend over all bars or over a sliding window
+  for (size_t window_size : {0, 250}) {
+    for (int degree : {3, 10}) {
+      RecursiveLeastSquares trend(degree, 1.0, window_size);
+      for (size_t i = 0; i < series.size(); ++i) {
+        trend.Update(series.Dates()[i], series.Prices()[i]);
+      }
+
+      time_t date = series.Dates().back();
+      std::string name = "BM_RecursiveLeastSquaresUpdate/" +
+                         std::to_string(degree) + "/" +
+                         std::to_string(window_size);
+      runner.Run(name, 1, [&trend, &date]() {
+        date += kSecondsPerDay;
+        trend.Update(date, 100.0);
+      });
+    }
+  }
+}
+
+void BenchmarkSimulation(BenchmarkRunner& runner) {
+  TimeSeries series = MakeRandomWalk(250, 0);
+  LeastSquaresPolynomial polynomial(series, 1);
+  std::vector<double> trend(series.size());
+  polynomial.ApproximatePrices(series.Dates().data(), series.size(),
+                               trend.data());
+  PriceSimulator simulator;
+  if (!simulator.Fit(series, trend)) {
+    std::fprintf(stderr, "%s\n", simulator.GetError().c_str());
+    return;
+  }
+
+  std::vector<time_t> dates(31);
+  for (size_t i = 0; i < dates.size(); ++i) {
+    dates[i] = series.Dates().back() + i * kSecondsPerDay;
+  }
+  std::vector<double> future_trend(dates.size());
+  polynomial.ApproximatePrices(dates.data(), dates.size(),
+                               future_trend.data());
+
+  ThreadPool pool;
+  std::vector<TimeSeries> bands;
+  for (size_t paths_count : {100'000, 1'000'000}) {
+    for (SimulationModel model : {SimulationModel::kGeometricBrownianMotion,
+                                  SimulationModel::kBootstrap}) {
+      SimulationSettings settings;
+      settings.model = model;
+      settings.paths_count = paths_count;
+      bool is_bootstrap = model == SimulationModel::kBootstrap;
+      std::string name = "BM_SimulatePaths/" + std::to_string(paths_count) +
+                         (is_bootstrap ? "/bootstrap" : "/gbm");
+      runner.Run(name, paths_count * (dates.size() - 1),
+                 [&simulator, &dates, &future_trend, &settings, &pool,
+                  &bands]() {
+                   simulator.Simulate(dates, future_trend, settings, pool,
+                                      bands);
+                 });
+    }
+  }
+}
+
+void BenchmarkForecaster(BenchmarkRunner& runner, size_t rows_count) {
+  std::string size = "/" + std::to_string(rows_count);
+  bool is_enabled = false;
+  for (const std::string& name :
+       {"BM_LoadData" + size, "BM_LoadCachedData" + size,
+        "BM_StockSplinePoint" + size,
+        "BM_StockSplineBatch" + size,
+        "BM_StockLeastSquaresBatch" + size + "/3",
+        "BM_StockRollingSpline" + size,
+        "BM_StockRollingLeastSquares" + size + "/3"}) {
+    is_enabled = is_enabled || runner.IsEnabled(name);
+  }
+
+  // the CSV is costly to generate, so skip it when all cases are filtered out
+  if (rows_count > kMaxCsvRows || !is_enabled) {
+    return;
+  }
+
+  // 1900-01-01
+  fs::path path = WriteCsv(MakeRandomWalk(rows_count, -2208988800));
+
+  // parsing the CSV every time, then reading the cache the first load wrote
+  StockForecaster model;
+  model.SetDataCacheEnabled(false);
+  if (!model.LoadData(path.string())) {
+    std::fprintf(stderr, "%s\n", model.GetError().c_str());
+    fs::remove(path);
+    return;
+  }
+
+  runner.Run("BM_LoadData" + size, rows_count,
+             [&model, &path]() { model.LoadData(path.string()); });
+
+  fs::path cache_path = path.string() + ".cache";
+  model.SetDataCacheEnabled(true);
+  model.LoadData(path.string());
+  runner.Run("BM_LoadCachedData" + size, rows_count,
+             [&model, &path]() { model.LoadData(path.string()); });
+  fs::remove(cache_path);
+
+  // pivot lookup and evaluation of single dates spread over the data
+  std::vector<time_t> dates(kQueriesCount);
+  std::mt19937_64 generator(7);
+  std::uniform_int_distribution<time_t> date(model.GetMinDate(),
+                                             model.GetMaxDate());
+  for (time_t& query_date : dates) {
+    query_date = date(generator);
+  }
+
+  runner.Run("BM_StockSplinePoint" + size, kQueriesCount, [&model, &dates]() {
+    for (time_t query_date : dates) {
+      model.InterpolatePriceByCubicSplineMethod(query_date);
+      DoNotOptimize(model.GetForecastPrice());
+    }
+  });
+
+  // batch evaluation with as many output points as rows
+  int points_count = static_cast<int>(rows_count);
+  runner.Run("BM_StockSplineBatch" + size, rows_count,
+             [&model, points_count]() {
+               model.InterpolatePricesByCubicSplineMethod(points_count);
+             });
+  runner.Run("BM_StockLeastSquaresBatch" + size + "/3", rows_count,
+             [&model, points_count]() {
+               model.ApproximatePricesByLeastSquaresMethod(points_count, 30, 3);
+             });
+
+  // walk-forward forecasts 5 rows ahead of every window of a year of rows
+  int window_size = std::min(250, points_count / 2);
+  runner.Run("BM_StockRollingSpline" + size, rows_count,
+             [&model, window_size]() {
+               model.InterpolateRollingPricesByCubicSplineMethod(window_size,
+                                                                 5);
+             });
+  runner.Run("BM_StockRollingLeastSquares" + size + "/3", rows_count,
+             [&model, window_size]() {
+               model.ApproximateRollingPricesByLeastSquaresMethod(window_size,
+                                                                  5, 3);
+             });
+
+  fs::remove(path);
+}
+
+int main(int argc, char* argv[]) {
+  BenchmarkRunner runner(argc, argv);
+  BenchmarkStreaming(runner);
+  BenchmarkSimulation(runner);
+
+  for (size_t rows_count : {250, 10'000, 100'000, 1'000'000, 10'000'000}) {
+    if (rows_count <= runner.GetMaxRows()) {
+      BenchmarkFitting(runner, rows_count);
+      BenchmarkSelection(runner, rows_count);
+      BenchmarkForecaster(runner, rows_count);
+    }
+  }
+
+  return runner.Finish() ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+// Compares the two ways of handing a forecast over to a QCustomPlot graph:
+//
+//   copy    the series is copied into key and value QVectors and passed to
+//           QCPGraph::setData, which copies them once more into the graph
+//   direct  the series is moved into a GraphDecimator, which fills the graph
+//           container with the already sorted points of the visible range
+//
+//   plot_handoff_bench [--points N]...
+//
+// Each path and size runs in a child process so that its peak resident set
+// size is its own. The report gives the time of the handoff with the first
+// replot and the peak memory on top of the generated series, both per
+// million points. Runs on the offscreen Qt platform, no display is needed.
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <QApplication>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../libs/qcustomplot.h"
+#include "../view_model/graph_decimator.h"
+#include "time_series.h"
+
+struct HandoffResult {
+  double seconds = 0.0;
+  double peak_megabytes = 0.0;
+};
+
+TimeSeries MakeRandomWalk(size_t points_count) {
+  std::mt19937_64 generator(42);
+  std::normal_distribution<double> step(0.0, 1.0);
+
+  TimeSeries series;
+  series.Reserve(points_count);
+  double price = 100.0;
+  for (size_t i = 0; i < points_count; ++i) {
+    series.Append(static_cast<time_t>(i) * 60, price);
+    price += step(generator);
+  }
+
+  return series;
+}
+
+double GetPeakMegabytes() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / (1024.0 * 1024.0);  // bytes
+#else
+  return usage.ru_maxrss / 1024.0;  // kilobytes
+#endif
+}
+
+HandoffResult RunHandoff(bool direct, size_t points_count) {
+  if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+  int argc = 1;
+  char name[] = "plot_handoff_bench";
+  char* argv[] = {name, nullptr};
+  QApplication application(argc, argv);
+
+  QCustomPlot plot;
+  plot.resize(1280, 720);
+  TimeSeries series = MakeRandomWalk(points_count);
+
+  HandoffResult result;
+  double peak_megabytes = GetPeakMegabytes();
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+  QCPGraph* graph = plot.addGraph();
+  if (direct) {
+    new GraphDecimator(graph, std::move(series));
+  } else {
+    QVector<double> dates, prices;
+    for (const DataPoint& data_point : series) {
+      dates.push_back(data_point.date.ToDouble());
+      prices.push_back(data_point.price);
+    }
+    graph->setData(dates, prices);
+  }
+  graph->rescaleAxes();
+  plot.replot();
+
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  result.peak_megabytes = GetPeakMegabytes() - peak_megabytes;
+  return result;
+}
+
+bool RunInChild(bool direct, size_t points_count, HandoffResult& result) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    return false;
+  }
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(fds[0]);
+    HandoffResult child_result = RunHandoff(direct, points_count);
+    bool written = write(fds[1], &child_result, sizeof(child_result)) ==
+                   static_cast<ssize_t>(sizeof(child_result));
+    _exit(written ? 0 : 1);
+  }
+
+  close(fds[1]);
+  bool is_read = pid > 0 && read(fds[0], &result, sizeof(result)) ==
+                                static_cast<ssize_t>(sizeof(result));
+  close(fds[0]);
+
+  int status = 0;
+  return pid > 0 && waitpid(pid, &status, 0) == pid && is_read &&
+         WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char* argv[]) {
+  std::vector<size_t> sizes;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::string(argv[i]) == "--points") {
+      sizes.push_back(std::strtoull(argv[i + 1], nullptr, 10));
+    } else {
+      std::fprintf(stderr, "Unknown option: %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if (sizes.empty()) {
+    sizes = {1'000'000, 10'000'000};
+  }
+
+  std::printf("%-8s %12s %16s %18s\n", "Path", "Points", "ms/M points",
+              "peak MB/M points");
+  for (size_t points_count : sizes) {
+    for (bool direct : {false, true}) {
+      HandoffResult result;
+      if (!RunInChild(direct, points_count, result)) {
+        std::fprintf(stderr, "Handoff of %zu points failed\n", points_count);
+        return 1;
+      }
+
+      double millions = points_count / 1e6;
+      std::printf("%-8s %12zu %16.2f %18.2f\n", direct ? "direct" : "copy",
+                  points_count, result.seconds * 1e3 / millions,
+                  result.peak_megabytes / millions);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,116 @@
+#include "command_line.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <map>
+
+#include "forecast_universe.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+template <typename T, typename Parse>
+bool ParseList(const std::string& text, Parse parse, std::vector<T>& values) {
+  values.clear();
+  size_t begin = 0;
+  while (begin <= text.size()) {
+    size_t end = std::min(text.find(',', begin), text.size());
+    T value{};
+    if (!parse(text.substr(begin, end - begin).c_str(), value)) {
+      return false;
+    }
+    values.push_back(value);
+    begin = end + 1;
+  }
+
+  return true;
+}
+
+// the same file reached as dir/AAPL.csv and ./dir/AAPL.csv, or through a
+// link, has one key
+fs::path DefineFileKey(const fs::path& file) {
+  std::error_code error;
+  fs::path key = fs::weakly_canonical(file, error);
+  return error ? file.lexically_normal() : key;
+}
+
+}  // namespace
+
+bool ParseInt(const char* text, int min_value, int& value, int max_value) {
+  char* end = nullptr;
+  errno = 0;
+  long parsed = std::strtol(text, &end, 10);
+  if (end == text || *end != '\0' || errno == ERANGE ||
+      parsed < min_value || parsed > max_value) {
+    return false;
+  }
+
+  value = static_cast<int>(parsed);
+  return true;
+}
+
+bool ParseDouble(const char* text, double& value) {
+  char* end = nullptr;
+  double parsed = std::strtod(text, &end);
+  if (end == text || *end != '\0' || parsed < 0.0) {
+    return false;
+  }
+
+  value = parsed;
+  return true;
+}
+
+bool ParseIntList(const std::string& text, int min_value,
+                  std::vector<int>& values) {
+  return ParseList(
+      text,
+      [min_value](const char* item, int& value) {
+        return ParseInt(item, min_value, value);
+      },
+      values);
+}
+
+bool ParseDoubleList(const std::string& text, std::vector<double>& values) {
+  return ParseList(text, ParseDouble, values);
+}
+
+std::vector<fs::path> CollectFiles(const std::vector<fs::path>& inputs,
+                                   std::vector<std::string>& errors) {
+  std::vector<fs::path> files;
+  for (const fs::path& input : inputs) {
+    std::error_code error;
+    if (!fs::is_directory(input, error)) {
+      files.push_back(input);
+      continue;
+    }
+
+    std::vector<std::string> file_paths;
+    if (!ForecastUniverse::ListFiles(input.string(), file_paths)) {
+      errors.push_back("Unable to read directory: " + input.string());
+    }
+    files.insert(files.end(), file_paths.begin(), file_paths.end());
+  }
+  std::sort(files.begin(), files.end());
+
+  std::vector<fs::path> unique_files;
+  std::map<fs::path, const fs::path*> key_files;
+  std::map<std::string, const fs::path*> symbol_files;
+  for (const fs::path& file : files) {
+    if (!key_files.emplace(DefineFileKey(file), &file).second) {
+      continue;
+    }
+
+    std::string symbol = file.stem().string();
+    auto [it, is_new] = symbol_files.emplace(symbol, &file);
+    if (!is_new) {
+      errors.push_back("Duplicate symbol " + symbol + ": " +
+                       it->second->string() + " and " + file.string());
+      continue;
+    }
+    unique_files.push_back(file);
+  }
+
+  return unique_files;
+}
@@ -0,0 +1,33 @@
+#ifndef ALGORITHMIC_TRADING_CLI_COMMANDLINE_H
+#define ALGORITHMIC_TRADING_CLI_COMMANDLINE_H
+
+#include <climits>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Option values and input files shared by the command-line tools.
+
+// more threads than any machine this runs on would only add contention
+const int kMaxThreadsCount = 1024;
+
+// the whole text as a number within the bounds, value is left as it was
+// otherwise; the doubles are never negative
+bool ParseInt(const char* text, int min_value, int& value,
+              int max_value = INT_MAX);
+bool ParseDouble(const char* text, double& value);
+// comma-separated, every item as above
+bool ParseIntList(const std::string& text, int min_value,
+                  std::vector<int>& values);
+bool ParseDoubleList(const std::string& text, std::vector<double>& values);
+
+// The files given and the CSV files directly in the directories given,
+// sorted, each once however it was named. The outputs and reports are keyed
+// by symbol, the file name without the extension, so a file whose symbol an
+// earlier one already has is left out; it and an unreadable directory add
+// one message each to errors.
+std::vector<std::filesystem::path> CollectFiles(
+    const std::vector<std::filesystem::path>& inputs,
+    std::vector<std::string>& errors);
+
+#endif  // ALGORITHMIC_TRADING_CLI_COMMANDLINE_H
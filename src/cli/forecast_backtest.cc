@@ -0,0 +1,257 @@
+// Command-line backtester: loads every CSV given on the command line (or
+// found in the given directories), trades the rolling forecasts of each
+// symbol over a grid of forecast and trading settings on a thread pool and
+// prints one CSV row of PnL, Sharpe ratio and drawdown per symbol and
+// setting. With --select, the least squares settings of the grid are scored
+// by walk-forward forecast errors instead, and the best ones per symbol and
+// horizon printed.
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "backtester.h"
+#include "command_line.h"
+#include "forecast_universe.h"
+#include "model_selector.h"
+#include "thread_pool.h"
+
+namespace fs = std::filesystem;
+
+struct BacktestOptions {
+  std::vector<ForecastMethod> methods = {ForecastMethod::kCubicSpline,
+                                         ForecastMethod::kLeastSquares};
+  std::vector<int> window_sizes = {250};
+  std::vector<int> horizons = {5};
+  std::vector<int> degrees = {3};
+  std::vector<double> thresholds = {0.0};
+  BacktestRules rules;
+  bool select = false;
+  size_t threads_count = ThreadPool::DefaultThreadsCount();
+  fs::path output_path;
+  std::vector<fs::path> inputs;
+};
+
+void PrintUsage(const char* program) {
+  std::cerr
+      << "Usage: " << program << " [options] <dir|file.csv>...\n"
+      << "Lists are comma-separated, every combination is backtested.\n"
+      << "  --method spline|lsm|both  forecasts to trade (default both)\n"
+      << "  --windows N,...           rolling window sizes, N >= 2 (250)\n"
+      << "  --horizons N,...          forecast horizons in data points (5)\n"
+      << "  --degrees N,...           least squares degrees (3)\n"
+      << "  --thresholds X,...        expected returns to trade on (0)\n"
+      << "  --commission X            per traded amount (0.0005)\n"
+      << "  --slippage X              per traded amount (0.0002)\n"
+      << "  --no-short                stay flat instead of going short\n"
+      << "  --select                  print the least squares window and\n"
+      << "                            degree of the lowest RMSE per horizon\n"
+      << "                            instead of trading\n"
+      << "  --output FILE             report file (standard output)\n"
+      << "  --threads N               worker threads, N <= 1024 (all cores)\n";
+}
+
+bool ParseOptions(int argc, char* argv[], BacktestOptions& options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--help") {
+      return false;
+    }
+
+    if (arg == "--no-short") {
+      options.rules.allow_short = false;
+      continue;
+    }
+
+    if (arg == "--select") {
+      options.select = true;
+      continue;
+    }
+
+    if (arg.rfind("--", 0) != 0) {
+      options.inputs.emplace_back(arg);
+      continue;
+    }
+
+    if (i + 1 == argc) {
+      std::cerr << "Missing value for " << arg << "\n";
+      return false;
+    }
+
+    const char* value = argv[++i];
+    bool valid = true;
+    if (arg == "--method") {
+      options.methods.clear();
+      if (!std::strcmp(value, "spline") || !std::strcmp(value, "both")) {
+        options.methods.push_back(ForecastMethod::kCubicSpline);
+      }
+      if (!std::strcmp(value, "lsm") || !std::strcmp(value, "both")) {
+        options.methods.push_back(ForecastMethod::kLeastSquares);
+      }
+      valid = !options.methods.empty();
+    } else if (arg == "--windows") {
+      valid = ParseIntList(value, 2, options.window_sizes);
+    } else if (arg == "--horizons") {
+      valid = ParseIntList(value, 1, options.horizons);
+    } else if (arg == "--degrees") {
+      valid = ParseIntList(value, 0, options.degrees);
+    } else if (arg == "--thresholds") {
+      valid = ParseDoubleList(value, options.thresholds);
+    } else if (arg == "--commission") {
+      valid = ParseDouble(value, options.rules.commission);
+    } else if (arg == "--slippage") {
+      valid = ParseDouble(value, options.rules.slippage);
+    } else if (arg == "--output") {
+      options.output_path = value;
+    } else if (arg == "--threads") {
+      int threads_count = 0;
+      valid = ParseInt(value, 1, threads_count, kMaxThreadsCount);
+      options.threads_count = threads_count;
+    } else {
+      std::cerr << "Unknown option: " << arg << "\n";
+      return false;
+    }
+
+    if (!valid) {
+      std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+      return false;
+    }
+  }
+
+  return !options.inputs.empty();
+}
+
+// the spline has no degree, so it gets one rule set per other setting
+std::vector<BacktestRules> DefineRulesSet(const BacktestOptions& options) {
+  std::vector<BacktestRules> rules_set;
+  for (ForecastMethod method : options.methods) {
+    std::vector<int> degrees = method == ForecastMethod::kCubicSpline
+                                   ? std::vector<int>{0}
+                                   : options.degrees;
+    for (int window_size : options.window_sizes) {
+      for (int horizon : options.horizons) {
+        for (int degree : degrees) {
+          for (double threshold : options.thresholds) {
+            BacktestRules rules = options.rules;
+            rules.method = method;
+            rules.window_size = window_size;
+            rules.horizon = horizon;
+            rules.degree = degree;
+            rules.threshold = threshold;
+            rules_set.push_back(rules);
+          }
+        }
+      }
+    }
+  }
+
+  return rules_set;
+}
+
+void WriteReports(std::ostream& os,
+                  const std::vector<BacktestReport>& reports) {
+  os << "Symbol,Method,Window,Horizon,Degree,Threshold,Trades,TotalReturn,"
+        "Sharpe,MaxDrawdown\n";
+  for (const BacktestReport& report : reports) {
+    if (!report.error_message.empty()) {
+      continue;
+    }
+
+    const BacktestRules& rules = report.rules;
+    bool is_spline = rules.method == ForecastMethod::kCubicSpline;
+    os << report.symbol << ',' << (is_spline ? "spline" : "lsm") << ','
+       << rules.window_size << ',' << rules.horizon << ','
+       << (is_spline ? 0 : rules.degree) << ',' << rules.threshold << ','
+       << report.trades_count << ',' << report.total_return << ','
+       << report.sharpe_ratio << ',' << report.max_drawdown << '\n';
+  }
+}
+
+// the best settings of every symbol, returns the count of symbols failed
+int WriteSelections(std::ostream& os,
+                    const std::vector<std::string>& file_paths,
+                    const BacktestOptions& options, ThreadPool& pool) {
+  int failed_count = 0;
+  ForecastUniverse universe;
+  if (!universe.Load(file_paths, pool)) {
+    std::cerr << universe.GetError() << "\n";
+    ++failed_count;
+  }
+
+  ModelSelectionGrid grid;
+  grid.degrees = options.degrees;
+  grid.window_sizes = options.window_sizes;
+  grid.horizons = options.horizons;
+  os << "Symbol,Horizon,Window,Degree,Forecasts,RMSE,MAE,MAPE\n";
+  for (const std::string& symbol : universe.GetSymbols()) {
+    ModelSelector selector;
+    if (!selector.Select(universe.Find(symbol)->GetData(), grid, pool)) {
+      std::cerr << symbol << ": " << selector.GetError() << "\n";
+      ++failed_count;
+      continue;
+    }
+
+    for (const ModelScore& score : selector.GetBest()) {
+      os << symbol << ',' << score.horizon << ',' << score.window_size << ','
+         << score.degree << ',' << score.forecasts_count << ',' << score.rmse
+         << ',' << score.mae << ',' << score.mape << '\n';
+    }
+  }
+
+  return failed_count;
+}
+
+int main(int argc, char* argv[]) {
+  BacktestOptions options;
+  if (!ParseOptions(argc, argv, options)) {
+    PrintUsage(argv[0]);
+    return 2;
+  }
+
+  std::vector<std::string> errors;
+  std::vector<std::string> file_paths;
+  for (const fs::path& file : CollectFiles(options.inputs, errors)) {
+    file_paths.push_back(file.string());
+  }
+  for (const std::string& error : errors) {
+    std::cerr << error << "\n";
+  }
+
+  std::ofstream ofs;
+  if (!options.output_path.empty()) {
+    ofs.open(options.output_path);
+  }
+  std::ostream& os = options.output_path.empty() ? std::cout : ofs;
+
+  ThreadPool pool(options.threads_count);
+  int failed_count = static_cast<int>(errors.size());
+  if (options.select) {
+    failed_count += WriteSelections(os, file_paths, options, pool);
+  } else {
+    Backtester backtester;
+    if (!backtester.Load(file_paths, pool)) {
+      std::cerr << backtester.GetError() << "\n";
+      ++failed_count;
+    }
+
+    std::vector<BacktestReport> reports =
+        backtester.Run(DefineRulesSet(options), pool);
+    for (const BacktestReport& report : reports) {
+      if (!report.error_message.empty()) {
+        std::cerr << report.symbol << ": " << report.error_message << "\n";
+        ++failed_count;
+      }
+    }
+    WriteReports(os, reports);
+  }
+
+  if (!os.good()) {
+    std::cerr << "Unable to write file: " << options.output_path << "\n";
+    return 1;
+  }
+
+  return failed_count == 0 ? 0 : 1;
+}
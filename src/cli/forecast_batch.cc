@@ -0,0 +1,294 @@
+// Command-line batch forecaster: loads every CSV given on the command line
+// (or found in the given directories), runs the spline and/or least squares
+// forecasts for each symbol on a thread pool and writes one output file per
+// symbol and method. With --paths, Monte Carlo paths around the least
+// squares trend are simulated on the same pool and their percentile bands
+// written per symbol as well.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "command_line.h"
+#include "stockforecaster.h"
+#include "thread_pool.h"
+
+namespace fs = std::filesystem;
+
+struct BatchOptions {
+  bool spline = true;
+  bool least_squares = true;
+  int points_count = 100;
+  int future_days = 0;
+  int degree = 3;
+  int paths_count = 0;  // no simulation
+  SimulationModel simulation_model = SimulationModel::kGeometricBrownianMotion;
+  bool binary_output = false;
+  size_t threads_count = ThreadPool::DefaultThreadsCount();
+  fs::path output_dir = "forecasts";
+  std::vector<fs::path> inputs;
+};
+
+struct SymbolReport {
+  std::string symbol;
+  size_t rows_count = 0;
+  std::string error_message;
+};
+
+void PrintUsage(const char* program) {
+  std::cerr
+      << "Usage: " << program << " [options] <dir|file.csv>...\n"
+      << "  --method spline|lsm|both  forecasts to run (default both)\n"
+      << "  --points N                points per forecast, N >= 2 (100)\n"
+      << "  --days N                  least squares days past the data (0)\n"
+      << "  --degree N                least squares polynomial degree (3)\n"
+      << "  --paths N                 paths simulated over --days, 0 for none "
+         "(0)\n"
+      << "  --model gbm|bootstrap     simulated shocks (gbm)\n"
+      << "  --format csv|binary       output format (csv)\n"
+      << "  --output DIR              output directory (forecasts)\n"
+      << "  --threads N               worker threads, N <= 1024 (all cores)\n";
+}
+
+bool ParseOptions(int argc, char* argv[], BatchOptions& options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--help") {
+      return false;
+    }
+
+    if (arg.rfind("--", 0) != 0) {
+      options.inputs.emplace_back(arg);
+      continue;
+    }
+
+    if (i + 1 == argc) {
+      std::cerr << "Missing value for " << arg << "\n";
+      return false;
+    }
+
+    const char* value = argv[++i];
+    bool valid = true;
+    if (arg == "--method") {
+      options.spline =
+          !std::strcmp(value, "spline") || !std::strcmp(value, "both");
+      options.least_squares =
+          !std::strcmp(value, "lsm") || !std::strcmp(value, "both");
+      valid = options.spline || options.least_squares;
+    } else if (arg == "--points") {
+      valid = ParseInt(value, 2, options.points_count);
+    } else if (arg == "--days") {
+      valid = ParseInt(value, 0, options.future_days);
+    } else if (arg == "--degree") {
+      valid = ParseInt(value, 0, options.degree);
+    } else if (arg == "--paths") {
+      valid = ParseInt(value, 0, options.paths_count);
+    } else if (arg == "--model") {
+      bool bootstrap = !std::strcmp(value, "bootstrap");
+      options.simulation_model =
+          bootstrap ? SimulationModel::kBootstrap
+                    : SimulationModel::kGeometricBrownianMotion;
+      valid = bootstrap || !std::strcmp(value, "gbm");
+    } else if (arg == "--format") {
+      options.binary_output = !std::strcmp(value, "binary");
+      valid = options.binary_output || !std::strcmp(value, "csv");
+    } else if (arg == "--output") {
+      options.output_dir = value;
+    } else if (arg == "--threads") {
+      int threads_count = 0;
+      valid = ParseInt(value, 1, threads_count, kMaxThreadsCount);
+      options.threads_count = threads_count;
+    } else {
+      std::cerr << "Unknown option: " << arg << "\n";
+      return false;
+    }
+
+    if (!valid) {
+      std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+      return false;
+    }
+  }
+
+  if (options.paths_count > 0 && options.future_days == 0) {
+    std::cerr << "--paths needs --days to simulate over\n";
+    return false;
+  }
+
+  return !options.inputs.empty();
+}
+
+// Binary layout: "ATFC", uint32 version, uint64 count, int64 timestamps[count],
+// double prices[count], all in native byte order
+bool WriteForecast(const fs::path& path, const TimeSeries& forecast,
+                   bool binary_output) {
+  std::ofstream ofs(path, binary_output ? std::ios::binary : std::ios::out);
+  if (!ofs.is_open()) {
+    return false;
+  }
+
+  if (binary_output) {
+    const uint32_t kVersion = 1;
+    uint64_t count = forecast.size();
+    ofs.write("ATFC", 4);
+    ofs.write(reinterpret_cast<const char*>(&kVersion), sizeof(kVersion));
+    ofs.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (time_t date : forecast.Dates()) {
+      int64_t timestamp = date;
+      ofs.write(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+    }
+    ofs.write(reinterpret_cast<const char*>(forecast.Prices().data()),
+              forecast.size() * sizeof(double));
+  } else {
+    ofs << "Timestamp,Price\n" << std::setprecision(10);
+    for (size_t i = 0; i < forecast.size(); ++i) {
+      ofs << forecast.Dates()[i] << ',' << forecast.Prices()[i] << '\n';
+    }
+  }
+
+  return ofs.good();
+}
+
+// Timestamp and one column per percentile, in CSV whatever the format
+bool WriteBands(const fs::path& path, const std::vector<double>& percentiles,
+                const std::vector<TimeSeries>& bands) {
+  std::ofstream ofs(path);
+  if (!ofs.is_open()) {
+    return false;
+  }
+
+  ofs << "Timestamp";
+  for (double percentile : percentiles) {
+    ofs << ",P" << percentile;
+  }
+  ofs << '\n' << std::setprecision(10);
+  for (size_t i = 0; i < bands.front().size(); ++i) {
+    ofs << bands.front().Dates()[i];
+    for (const TimeSeries& band : bands) {
+      ofs << ',' << band.Prices()[i];
+    }
+    ofs << '\n';
+  }
+
+  return ofs.good();
+}
+
+SymbolReport ForecastSymbol(const fs::path& file, const BatchOptions& options,
+                            ThreadPool& pool) {
+  SymbolReport report;
+  report.symbol = file.stem().string();
+
+  StockForecaster model;
+  if (!model.LoadData(file.string())) {
+    report.error_message = model.GetError();
+    return report;
+  }
+  report.rows_count = model.GetData().size();
+
+  const char* extension = options.binary_output ? ".bin" : ".csv";
+  if (options.spline) {
+    if (!model.InterpolatePricesByCubicSplineMethod(options.points_count)) {
+      report.error_message = model.GetError();
+      return report;
+    }
+
+    fs::path path =
+        options.output_dir / (report.symbol + "_spline" + extension);
+    if (!WriteForecast(path, model.GetForecast(), options.binary_output)) {
+      report.error_message = "Unable to write file: " + path.string();
+      return report;
+    }
+  }
+
+  if (options.least_squares) {
+    if (!model.ApproximatePricesByLeastSquaresMethod(
+            options.points_count, options.future_days, options.degree)) {
+      report.error_message = model.GetError();
+      return report;
+    }
+
+    fs::path path = options.output_dir / (report.symbol + "_lsm" + extension);
+    if (!WriteForecast(path, model.GetForecast(), options.binary_output)) {
+      report.error_message = "Unable to write file: " + path.string();
+      return report;
+    }
+  }
+
+  if (options.paths_count > 0) {
+    SimulationSettings settings;
+    settings.model = options.simulation_model;
+    settings.paths_count = options.paths_count;
+    if (!model.SimulatePricesByLeastSquaresMethod(
+            options.points_count, options.future_days, options.degree,
+            settings, pool)) {
+      report.error_message = model.GetError();
+      return report;
+    }
+
+    fs::path path = options.output_dir / (report.symbol + "_bands.csv");
+    if (!WriteBands(path, settings.percentiles, model.GetForecastBands())) {
+      report.error_message = "Unable to write file: " + path.string();
+      return report;
+    }
+  }
+
+  return report;
+}
+
+int main(int argc, char* argv[]) {
+  BatchOptions options;
+  if (!ParseOptions(argc, argv, options)) {
+    PrintUsage(argv[0]);
+    return 2;
+  }
+
+  std::error_code error;
+  fs::create_directories(options.output_dir, error);
+  if (error) {
+    std::cerr << "Unable to create directory: " << options.output_dir << "\n";
+    return 1;
+  }
+
+  // a repeated symbol would overwrite the outputs of the first one
+  std::vector<std::string> errors;
+  std::vector<fs::path> files = CollectFiles(options.inputs, errors);
+  for (const std::string& error : errors) {
+    std::cerr << error << "\n";
+  }
+
+  // the simulations of a symbol run on the pool too
+  ThreadPool pool(options.paths_count > 0
+                      ? options.threads_count
+                      : std::min(options.threads_count,
+                                 std::max<size_t>(files.size(), 1)));
+  std::vector<std::future<SymbolReport>> reports;
+  reports.reserve(files.size());
+  for (const fs::path& file : files) {
+    reports.push_back(pool.Submit([&file, &options, &pool]() {
+      return ForecastSymbol(file, options, pool);
+    }));
+  }
+
+  int failed_count = static_cast<int>(errors.size());
+  for (std::future<SymbolReport>& future : reports) {
+    SymbolReport report = future.get();
+    if (report.error_message.empty()) {
+      std::cout << report.symbol << ": " << report.rows_count << " rows\n";
+    } else {
+      std::cerr << report.symbol << ": " << report.error_message << "\n";
+      ++failed_count;
+    }
+  }
+
+  size_t inputs_count = files.size() + errors.size();
+  std::cout << inputs_count - failed_count << " of " << inputs_count
+            << " symbols forecasted\n";
+
+  return failed_count == 0 ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+#include "backtester.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <tuple>
+
+namespace {
+
+struct ForecastResult {
+  TimeSeries forecast;
+  std::string error_message;
+};
+
+// the model is shared by the tasks of its symbol, each fits its own window
+ForecastResult MakeForecast(const StockForecaster& model,
+                            const BacktestRules& rules) {
+  ForecastResult result;
+  if (rules.method == ForecastMethod::kCubicSpline) {
+    model.InterpolateRollingPricesByCubicSplineMethod(
+        rules.window_size, rules.horizon, result.forecast,
+        result.error_message);
+  } else {
+    model.ApproximateRollingPricesByLeastSquaresMethod(
+        rules.window_size, rules.horizon, rules.degree, result.forecast,
+        result.error_message);
+  }
+
+  return result;
+}
+
+int DefineSignal(double price, double forecast_price,
+                 const BacktestRules& rules) {
+  double expected_return = forecast_price / price - 1.0;
+  if (expected_return > rules.threshold) {
+    return 1;
+  }
+  if (expected_return < -rules.threshold) {
+    return rules.allow_short ? -1 : 0;
+  }
+
+  return 0;
+}
+
+}  // namespace
+
+bool Backtester::AddSymbol(const std::string& symbol,
+                           const std::string& file_path) {
+  return universe_.AddSymbol(symbol, file_path);
+}
+
+bool Backtester::Load(const std::vector<std::string>& file_paths,
+                      ThreadPool& pool) {
+  return universe_.Load(file_paths, pool);
+}
+
+std::vector<BacktestReport> Backtester::Run(
+    const std::vector<BacktestRules>& rules_set, ThreadPool& pool) const {
+  // one forecast per symbol and forecast settings, the spline has no degree
+  using ForecastKey = std::tuple<size_t, ForecastMethod, int, int, int>;
+  std::map<ForecastKey, size_t> forecast_idxs;
+  std::vector<size_t> report_forecast_idxs;
+  std::vector<const BacktestRules*> forecast_rules;
+  std::vector<const StockForecaster*> forecast_models;
+  std::vector<std::string> symbols = universe_.GetSymbols();
+  for (size_t s = 0; s < symbols.size(); ++s) {
+    for (const BacktestRules& rules : rules_set) {
+      int degree =
+          rules.method == ForecastMethod::kCubicSpline ? 0 : rules.degree;
+      ForecastKey key{s, rules.method, rules.window_size, rules.horizon,
+                      degree};
+      auto [it, is_new] = forecast_idxs.emplace(key, forecast_rules.size());
+      if (is_new) {
+        forecast_rules.push_back(&rules);
+        forecast_models.push_back(universe_.Find(symbols[s]));
+      }
+      report_forecast_idxs.push_back(it->second);
+    }
+  }
+
+  // the simulations only start once every forecast is done; Wait() runs the
+  // group's own tasks, so a caller on a pool worker does not hold it idle
+  std::vector<ForecastResult> forecasts(forecast_rules.size());
+  ThreadPool::TaskGroup forecast_tasks(pool);
+  for (size_t i = 0; i < forecasts.size(); ++i) {
+    forecast_tasks.Run([&, i]() {
+      forecasts[i] = MakeForecast(*forecast_models[i], *forecast_rules[i]);
+    });
+  }
+  forecast_tasks.Wait();
+
+  std::vector<BacktestReport> reports(report_forecast_idxs.size());
+  ThreadPool::TaskGroup report_tasks(pool);
+  for (size_t i = 0; i < reports.size(); ++i) {
+    report_tasks.Run([&, i]() {
+      const std::string& symbol = symbols[i / rules_set.size()];
+      const BacktestRules& rules = rules_set[i % rules_set.size()];
+      const ForecastResult& forecast = forecasts[report_forecast_idxs[i]];
+      BacktestReport& report = reports[i];
+      if (forecast.error_message.empty()) {
+        report = Simulate(universe_.Find(symbol)->GetData(), forecast.forecast,
+                          rules);
+      } else {
+        report.rules = rules;
+        report.error_message = forecast.error_message;
+      }
+      report.symbol = symbol;
+    });
+  }
+  report_tasks.Wait();
+
+  return reports;
+}
+
+BacktestReport Backtester::Simulate(const TimeSeries& data,
+                                    const TimeSeries& forecast,
+                                    const BacktestRules& rules) {
+  BacktestReport report;
+  report.rules = rules;
+  if (forecast.empty() || forecast.size() + rules.horizon > data.size()) {
+    report.error_message = "Forecast does not match the data";
+    return report;
+  }
+
+  // forecast k is made at the close of the data point first_idx + k
+  const std::vector<double>& prices = data.Prices();
+  size_t first_idx = data.size() - rules.horizon - forecast.size();
+
+  double equity = 1.0, peak_equity = 1.0;
+  double returns_sum = 0.0, squared_returns_sum = 0.0;
+  size_t returns_count = 0;
+  int position = 0;
+  for (size_t i = first_idx + 1; i < data.size(); ++i) {
+    // the position held since the previous close, then the fill at this one
+    // of the signal of the previous close
+    double bar_return = position * (prices[i] / prices[i - 1] - 1.0);
+    size_t forecast_idx = i - 1 - first_idx;
+    int target_position =
+        forecast_idx < forecast.size()
+            ? DefineSignal(prices[i - 1], forecast.Prices()[forecast_idx],
+                           rules)
+            : position;
+    double cost = std::abs(target_position - position) *
+                  (rules.commission + rules.slippage);
+    if (target_position != position) {
+      ++report.trades_count;
+      position = target_position;
+    }
+
+    double net_return = (1.0 + bar_return) * (1.0 - cost) - 1.0;
+    equity *= 1.0 + net_return;
+    peak_equity = std::max(peak_equity, equity);
+    report.max_drawdown =
+        std::max(report.max_drawdown, 1.0 - equity / peak_equity);
+
+    returns_sum += net_return;
+    squared_returns_sum += net_return * net_return;
+    ++returns_count;
+  }
+
+  report.total_return = equity - 1.0;
+  if (returns_count > 1) {
+    double mean = returns_sum / returns_count;
+    double variance = (squared_returns_sum - returns_count * mean * mean) /
+                      (returns_count - 1);
+    report.sharpe_ratio =
+        variance > 0.0
+            ? mean / std::sqrt(variance) * std::sqrt(rules.periods_per_year)
+            : 0.0;
+  }
+
+  return report;
+}
+
+const std::string& Backtester::GetError() const {
+  return universe_.GetError();
+}
@@ -0,0 +1,69 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_BACKTESTER_H
+#define ALGORITHMIC_TRADING_MODEL_BACKTESTER_H
+
+#include <string>
+#include <vector>
+
+#include "forecast_universe.h"
+#include "stockforecaster.h"
+#include "thread_pool.h"
+#include "time_series.h"
+
+enum class ForecastMethod { kCubicSpline, kLeastSquares };
+
+// Trading rules of a backtest. At every close a rolling forecast horizon
+// data points ahead is compared with the price: an expected return above
+// the threshold goes long, below minus the threshold goes short (or flat
+// without shorts), and anything between goes flat. The position is filled
+// at the next close, and every change of the whole position costs the
+// commission and the slippage, both as a fraction of the traded amount.
+struct BacktestRules {
+  ForecastMethod method = ForecastMethod::kLeastSquares;
+  int window_size = 250;
+  int horizon = 5;
+  int degree = 3;  // least squares only
+  double threshold = 0.0;
+  bool allow_short = true;
+  double commission = 0.0005;
+  double slippage = 0.0002;
+  int periods_per_year = 252;  // data points, to annualize the Sharpe ratio
+};
+
+struct BacktestReport {
+  std::string symbol;
+  BacktestRules rules;
+  std::string error_message;  // empty when the backtest ran
+
+  size_t trades_count = 0;
+  double total_return = 0.0;  // of the starting capital
+  double sharpe_ratio = 0.0;
+  double max_drawdown = 0.0;  // fraction of the highest equity
+};
+
+// Walk-forward backtests of forecast signals over many symbols and rule
+// sets. Forecasts are computed once per symbol and forecast settings and
+// shared by the rule sets differing only in trading, and both the forecasts
+// and the simulations run on a thread pool.
+class Backtester {
+ public:
+  bool AddSymbol(const std::string& symbol, const std::string& file_path);
+  // loads the files in parallel, see ForecastUniverse::Load
+  bool Load(const std::vector<std::string>& file_paths, ThreadPool& pool);
+
+  // one report per symbol and rule set, symbol-major in ascending order
+  std::vector<BacktestReport> Run(const std::vector<BacktestRules>& rules_set,
+                                  ThreadPool& pool) const;
+
+  // trades the forecast of InterpolateRolling... or ApproximateRolling...
+  // over the data it was made from
+  static BacktestReport Simulate(const TimeSeries& data,
+                                 const TimeSeries& forecast,
+                                 const BacktestRules& rules);
+
+  const std::string& GetError() const;
+
+ private:
+  ForecastUniverse universe_;
+};
+
+#endif  // ALGORITHMIC_TRADING_MODEL_BACKTESTER_H
@@ -0,0 +1,221 @@
+#include "batch_evaluator.h"
+
+#include "chebyshev.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define ALGORITHMIC_TRADING_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using CubicKernel = void (*)(const CubicSegments&, const time_t*,
+                             const size_t*, size_t, double*);
+using ChebyshevKernel = void (*)(const double*, size_t, double, double,
+                             const time_t*, size_t, double*);
+
+struct Kernels {
+  CubicKernel cubic;
+  ChebyshevKernel chebyshev;
+  const char* isa;
+};
+
+void EvaluateCubicSegmentsScalar(const CubicSegments& segments,
+                                 const time_t* dates, const size_t* pivot_idxs,
+                                 size_t count, double* prices) {
+  for (size_t i = 0; i < count; ++i) {
+    size_t k = pivot_idxs[i];
+    double t = static_cast<double>(dates[i] - segments.dates[k]);
+    prices[i] =
+        ((segments.d[k] * t + segments.c[k]) * t + segments.b[k]) * t +
+        segments.a[k];
+  }
+}
+
+void EvaluateChebyshevSeriesScalar(const double* coeffs, size_t coeffs_count,
+                                   double center, double scale,
+                                   const time_t* dates, size_t count,
+                                   double* prices) {
+  for (size_t i = 0; i < count; ++i) {
+    double x = (dates[i] - center) / scale;
+    prices[i] = SumChebyshevSeries(coeffs, coeffs_count, x);
+  }
+}
+
+#ifdef ALGORITHMIC_TRADING_X86_KERNELS
+
+static_assert(sizeof(time_t) == 8 && sizeof(size_t) == 8,
+              "the kernels gather 64-bit dates by 64-bit indices");
+
+// 2^52 + 2^51: an integer added to its mantissa is read back exactly as a
+// double, for |x| < 2^51 seconds, without AVX-512DQ conversions
+const long long kMagicBits = 0x4338000000000000LL;
+const double kMagic = 6755399441055744.0;
+
+__attribute__((target("avx2"))) inline __m256d ConvertToDouble(__m256i x) {
+  return _mm256_sub_pd(
+      _mm256_castsi256_pd(_mm256_add_epi64(x, _mm256_set1_epi64x(kMagicBits))),
+      _mm256_set1_pd(kMagic));
+}
+
+__attribute__((target("avx2,fma"))) void EvaluateCubicSegmentsAvx2(
+    const CubicSegments& segments, const time_t* dates,
+    const size_t* pivot_idxs, size_t count, double* prices) {
+  const long long* knots = reinterpret_cast<const long long*>(segments.dates);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i idxs = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(pivot_idxs + i));
+    __m256i date =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dates + i));
+    __m256d t = ConvertToDouble(
+        _mm256_sub_epi64(date, _mm256_i64gather_epi64(knots, idxs, 8)));
+
+    __m256d price = _mm256_i64gather_pd(segments.d, idxs, 8);
+    price = _mm256_fmadd_pd(price, t, _mm256_i64gather_pd(segments.c, idxs, 8));
+    price = _mm256_fmadd_pd(price, t, _mm256_i64gather_pd(segments.b, idxs, 8));
+    price = _mm256_fmadd_pd(price, t, _mm256_i64gather_pd(segments.a, idxs, 8));
+    _mm256_storeu_pd(prices + i, price);
+  }
+
+  EvaluateCubicSegmentsScalar(segments, dates + i, pivot_idxs + i, count - i,
+                              prices + i);
+}
+
+// Clenshaw's recurrence of SumChebyshevSeries across the lanes
+__attribute__((target("avx2,fma"))) void EvaluateChebyshevSeriesAvx2(
+    const double* coeffs, size_t coeffs_count, double center, double scale,
+    const time_t* dates, size_t count, double* prices) {
+  __m256d centers = _mm256_set1_pd(center);
+  __m256d scales = _mm256_set1_pd(scale);
+  size_t i = 0;
+  for (; i + 4 <= count && coeffs_count > 0; i += 4) {
+    __m256d date = ConvertToDouble(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dates + i)));
+    __m256d x = _mm256_div_pd(_mm256_sub_pd(date, centers), scales);
+    __m256d two_x = _mm256_add_pd(x, x);
+
+    __m256d next = _mm256_setzero_pd();
+    __m256d next_next = _mm256_setzero_pd();
+    for (size_t k = coeffs_count; k-- > 1;) {
+      __m256d current = _mm256_fmadd_pd(
+          two_x, next, _mm256_sub_pd(_mm256_set1_pd(coeffs[k]), next_next));
+      next_next = next;
+      next = current;
+    }
+    __m256d price = _mm256_fmadd_pd(
+        x, next, _mm256_sub_pd(_mm256_set1_pd(coeffs[0]), next_next));
+    _mm256_storeu_pd(prices + i, price);
+  }
+
+  EvaluateChebyshevSeriesScalar(coeffs, coeffs_count, center, scale,
+                                dates + i, count - i, prices + i);
+}
+
+__attribute__((target("avx512f"))) inline __m512d ConvertToDouble512(
+    __m512i x) {
+  return _mm512_sub_pd(
+      _mm512_castsi512_pd(_mm512_add_epi64(x, _mm512_set1_epi64(kMagicBits))),
+      _mm512_set1_pd(kMagic));
+}
+
+// masked with every lane set, as the unmasked gathers leave their source
+// undefined and trip -Wmaybe-uninitialized in GCC
+__attribute__((target("avx512f"))) inline __m512d Gather512(
+    const double* base, __m512i idxs) {
+  return _mm512_mask_i64gather_pd(_mm512_setzero_pd(), 0xff, idxs, base, 8);
+}
+
+__attribute__((target("avx512f"))) inline __m512i Gather512(
+    const time_t* base, __m512i idxs) {
+  return _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), 0xff, idxs, base,
+                                     8);
+}
+
+__attribute__((target("avx512f"))) void EvaluateCubicSegmentsAvx512(
+    const CubicSegments& segments, const time_t* dates,
+    const size_t* pivot_idxs, size_t count, double* prices) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m512i idxs = _mm512_loadu_si512(pivot_idxs + i);
+    __m512i date = _mm512_loadu_si512(dates + i);
+    __m512d t = ConvertToDouble512(
+        _mm512_sub_epi64(date, Gather512(segments.dates, idxs)));
+
+    __m512d price = Gather512(segments.d, idxs);
+    price = _mm512_fmadd_pd(price, t, Gather512(segments.c, idxs));
+    price = _mm512_fmadd_pd(price, t, Gather512(segments.b, idxs));
+    price = _mm512_fmadd_pd(price, t, Gather512(segments.a, idxs));
+    _mm512_storeu_pd(prices + i, price);
+  }
+
+  EvaluateCubicSegmentsScalar(segments, dates + i, pivot_idxs + i, count - i,
+                              prices + i);
+}
+
+__attribute__((target("avx512f"))) void EvaluateChebyshevSeriesAvx512(
+    const double* coeffs, size_t coeffs_count, double center, double scale,
+    const time_t* dates, size_t count, double* prices) {
+  __m512d centers = _mm512_set1_pd(center);
+  __m512d scales = _mm512_set1_pd(scale);
+  size_t i = 0;
+  for (; i + 8 <= count && coeffs_count > 0; i += 8) {
+    __m512d date = ConvertToDouble512(_mm512_loadu_si512(dates + i));
+    __m512d x = _mm512_div_pd(_mm512_sub_pd(date, centers), scales);
+    __m512d two_x = _mm512_add_pd(x, x);
+
+    __m512d next = _mm512_setzero_pd();
+    __m512d next_next = _mm512_setzero_pd();
+    for (size_t k = coeffs_count; k-- > 1;) {
+      __m512d current = _mm512_fmadd_pd(
+          two_x, next, _mm512_sub_pd(_mm512_set1_pd(coeffs[k]), next_next));
+      next_next = next;
+      next = current;
+    }
+    __m512d price = _mm512_fmadd_pd(
+        x, next, _mm512_sub_pd(_mm512_set1_pd(coeffs[0]), next_next));
+    _mm512_storeu_pd(prices + i, price);
+  }
+
+  EvaluateChebyshevSeriesScalar(coeffs, coeffs_count, center, scale,
+                                dates + i, count - i, prices + i);
+}
+
+#endif  // ALGORITHMIC_TRADING_X86_KERNELS
+
+const Kernels& GetKernels() {
+  static const Kernels kernels = []() {
+#ifdef ALGORITHMIC_TRADING_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+      return Kernels{EvaluateCubicSegmentsAvx512,
+                     EvaluateChebyshevSeriesAvx512, "avx512"};
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+      return Kernels{EvaluateCubicSegmentsAvx2, EvaluateChebyshevSeriesAvx2,
+                     "avx2"};
+    }
+#endif
+    return Kernels{EvaluateCubicSegmentsScalar, EvaluateChebyshevSeriesScalar,
+                   "scalar"};
+  }();
+
+  return kernels;
+}
+
+}  // namespace
+
+void EvaluateCubicSegments(const CubicSegments& segments, const time_t* dates,
+                           const size_t* pivot_idxs, size_t count,
+                           double* prices) {
+  GetKernels().cubic(segments, dates, pivot_idxs, count, prices);
+}
+
+void EvaluateChebyshevSeries(const std::vector<double>& coeffs, double center,
+                             double scale, const time_t* dates, size_t count,
+                             double* prices) {
+  GetKernels().chebyshev(coeffs.data(), coeffs.size(), center, scale, dates,
+                         count, prices);
+}
+
+const char* GetBatchEvaluatorIsa() { return GetKernels().isa; }
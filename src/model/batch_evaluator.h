@@ -0,0 +1,39 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_BATCHEVALUATOR_H
+#define ALGORITHMIC_TRADING_MODEL_BATCHEVALUATOR_H
+
+#include <ctime>
+#include <vector>
+
+// Batch evaluation of fitted curves at many dates per call. On x86 the
+// kernels are compiled for AVX2 + FMA and AVX-512 next to the portable
+// ones, and the widest the CPU supports is picked once at run time, so the
+// binary itself needs no -m flags. The cubics are evaluated by Horner's
+// scheme and the Chebyshev series by Clenshaw's recurrence; the vector
+// kernels round each step once with FMA, so their results may differ from
+// the portable ones in the last bits.
+
+// cubic segments in structure-of-arrays form, segment k is
+// a[k] + b[k] * t + c[k] * t^2 + d[k] * t^3 with t = date - dates[k]
+struct CubicSegments {
+  const time_t* dates;
+  const double* a;
+  const double* b;
+  const double* c;
+  const double* d;
+};
+
+// prices[i] of the segment pivot_idxs[i] at dates[i]
+void EvaluateCubicSegments(const CubicSegments& segments, const time_t* dates,
+                           const size_t* pivot_idxs, size_t count,
+                           double* prices);
+
+// prices[i] of the sum of coeffs[k] * T(k)(x), x = (dates[i] - center) / scale,
+// see SumChebyshevSeries
+void EvaluateChebyshevSeries(const std::vector<double>& coeffs, double center,
+                             double scale, const time_t* dates, size_t count,
+                             double* prices);
+
+// "avx512", "avx2" or "scalar", the kernels picked for this CPU
+const char* GetBatchEvaluatorIsa();
+
+#endif  // ALGORITHMIC_TRADING_MODEL_BATCHEVALUATOR_H
@@ -0,0 +1,63 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_CHEBYSHEV_H
+#define ALGORITHMIC_TRADING_MODEL_CHEBYSHEV_H
+
+#include <vector>
+
+#include "matrix.h"
+
+// Chebyshev polynomials of the first kind, T(0) = 1, T(1) = x and
+// T(k+1) = 2x * T(k) - T(k-1). Bounded by 1 on [-1, 1], they are a far
+// better conditioned basis for least squares there than the powers of x.
+
+// T(0)(x), T(1)(x), ... for the whole size of values
+inline void DefineChebyshevValues(double x, std::vector<double>& values) {
+  if (values.empty()) {
+    return;
+  }
+
+  values[0] = 1.0;
+  if (values.size() > 1) {
+    values[1] = x;
+  }
+  for (size_t k = 1; k + 1 < values.size(); ++k) {
+    values[k + 1] = 2.0 * x * values[k] - values[k - 1];
+  }
+}
+
+// sum of coeffs[k] * T(k)(x), k < count, by Clenshaw's recurrence
+inline double SumChebyshevSeries(const double* coeffs, size_t count,
+                                 double x) {
+  if (count == 0) {
+    return 0.0;
+  }
+
+  double next = 0.0, next_next = 0.0;
+  for (size_t k = count; k-- > 1;) {
+    double current = coeffs[k] + 2.0 * x * next - next_next;
+    next_next = next;
+    next = current;
+  }
+
+  return coeffs[0] + x * next - next_next;
+}
+
+inline double SumChebyshevSeries(const std::vector<double>& coeffs, double x) {
+  return SumChebyshevSeries(coeffs.data(), coeffs.size(), x);
+}
+
+// normal equations of the basis T(0), ..., T(size-1) over points whose sums of
+// T(k), k <= 2 * (size - 1), are moments; follows from
+// T(i) * T(j) = (T(i+j) + T(|i-j|)) / 2
+inline ScratchMatrix DefineChebyshevGramMatrix(const double* moments,
+                                               size_t size) {
+  ScratchMatrix gram(size, size);
+  for (size_t i = 0; i < size; ++i) {
+    for (size_t j = 0; j < size; ++j) {
+      gram[i][j] = (moments[i + j] + moments[i > j ? i - j : j - i]) / 2.0;
+    }
+  }
+
+  return gram;
+}
+
+#endif  // ALGORITHMIC_TRADING_MODEL_CHEBYSHEV_H
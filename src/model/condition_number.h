@@ -0,0 +1,73 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_CONDITIONNUMBER_H
+#define ALGORITHMIC_TRADING_MODEL_CONDITIONNUMBER_H
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include "scratch_arena.h"
+
+// Bounds shared by the solvers of the normal equations, and the estimate of
+// the condition number they are checked against.
+
+// a system this ill-conditioned leaves its solution fewer than 4 of the 16
+// digits of a double, the fits reject it rather than forecast from noise
+const double kMaxConditionNumber = 1e12;
+
+// a pivot below this share of the norm of its matrix is what rounding
+// leaves of an exact zero, and is taken for one
+inline double DefinePivotTolerance(size_t size, double norm) {
+  return size * std::numeric_limits<double>::epsilon() * norm;
+}
+
+// ||A^-1|| in the 1-norm by Hager's method, from a few solves instead of the
+// inverse: solve(x) overwrites x with A^-1 * x, solve_transposed with
+// A^-T * x. The method climbs the convex function ||A^-1 * x|| over the unit
+// ball of the 1-norm, whose maximum lies on a vertex e(j); it usually stops
+// after two or three steps with an estimate within a small factor of the
+// norm. Uses scratch memory.
+template <typename Solve, typename SolveTransposed>
+double EstimateInverseNorm(size_t size, Solve solve,
+                           SolveTransposed solve_transposed) {
+  if (size == 0) {
+    return 0.0;
+  }
+
+  ScratchArena::Scope scope;
+  ScratchVector<double> x(size, 1.0 / size);
+  ScratchVector<double> y(size);
+  double inverse_norm = 0.0;
+  for (int step = 0; step < 5; ++step) {
+    y = x;
+    solve(y.data());
+    double estimate = 0.0;
+    for (double value : y) {
+      estimate += std::fabs(value);
+    }
+    if (step > 0 && estimate <= inverse_norm) {
+      break;
+    }
+    inverse_norm = estimate;
+
+    for (double& value : y) {
+      value = value >= 0.0 ? 1.0 : -1.0;
+    }
+    solve_transposed(y.data());
+
+    size_t max_idx = 0;
+    double projection = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+      max_idx = std::fabs(y[i]) > std::fabs(y[max_idx]) ? i : max_idx;
+      projection += y[i] * x[i];
+    }
+    if (step > 0 && std::fabs(y[max_idx]) <= projection) {
+      break;
+    }
+    x.assign(size, 0.0);
+    x[max_idx] = 1.0;
+  }
+
+  return inverse_norm;
+}
+
+#endif  // ALGORITHMIC_TRADING_MODEL_CONDITIONNUMBER_H
@@ -0,0 +1,116 @@
+#include "cubic_spline.h"
+
+#include <cmath>
+
+#include "batch_evaluator.h"
+
+CubicSpline::CubicSpline(const TimeSeries& data)
+    : CubicSpline(data, 0, data.size()) {}
+
+CubicSpline::CubicSpline(const TimeSeries& data, size_t first_idx,
+                         size_t last_idx) {
+  Fit(data, first_idx, last_idx);
+}
+
+void CubicSpline::Fit(const TimeSeries& data, size_t first_idx,
+                      size_t last_idx) {
+  dates_.assign(data.Dates().begin() + first_idx,
+                data.Dates().begin() + last_idx);
+  coeffs_[A].assign(data.Prices().begin() + first_idx,
+                    data.Prices().begin() + last_idx);
+  coeffs_[B].resize(dates_.size());
+  coeffs_[C].resize(dates_.size());
+  coeffs_[D].resize(dates_.size());
+  DefineInterpolationCoefficients(0);
+}
+
+void CubicSpline::Append(time_t date, double price) {
+  dates_.push_back(date);
+  coeffs_[A].push_back(price);
+  coeffs_[B].push_back(0.0);
+  coeffs_[C].push_back(0.0);
+  coeffs_[D].push_back(0.0);
+
+  DefineInterpolationCoefficients(
+      dates_.size() > kTailSize + 1 ? dates_.size() - kTailSize - 1 : 0);
+}
+
+double CubicSpline::InterpolatePrice(time_t date,
+                                     size_t pivot_date_idx) const {
+  double prices;
+  InterpolatePrices(&date, &pivot_date_idx, 1, &prices);
+  return prices;
+}
+
+void CubicSpline::InterpolatePrices(const time_t* dates,
+                                    const size_t* pivot_date_idxs,
+                                    size_t count, double* prices) const {
+  CubicSegments segments{dates_.data(), coeffs_[A].data(), coeffs_[B].data(),
+                         coeffs_[C].data(), coeffs_[D].data()};
+  EvaluateCubicSegments(segments, dates, pivot_date_idxs, count, prices);
+
+  // past the last knot the spline goes on along its tangent, as a natural
+  // spline has no curvature there and the cubic of the last segment would
+  // run away within days
+  time_t last_date = dates_.back();
+  for (size_t i = 0; i < count; ++i) {
+    if (dates[i] > last_date) {
+      prices[i] = coeffs_[A].back() +
+                  coeffs_[B].back() * static_cast<double>(dates[i] - last_date);
+    }
+  }
+}
+
+void CubicSpline::DefineInterpolationCoefficients(size_t first_idx) {
+  const std::vector<double>& prices = coeffs_[A];
+  size_t size = dates_.size() - first_idx;
+
+  ScratchArena::Scope scope;
+  ScratchVector<time_t> dx(size);  // date intervals
+  ScratchVector<double> dy(size);  // price intervals
+  for (size_t i = 1; i < size; ++i) {
+    dx[i] = dates_[first_idx + i] - dates_[first_idx + i - 1];
+    dy[i] = prices[first_idx + i] - prices[first_idx + i - 1];
+  }
+
+  // make SLE, the first row is the natural boundary or the kept knot
+  TridiagonalSle sle(size);
+  sle.main.front() = 1;
+  sle.main.back() = 1;
+  sle.rhs.front() = first_idx > 0 ? coeffs_[C][first_idx] : 0.0;
+  for (size_t i = 1; i < size - 1; ++i) {
+    sle.lower[i] = dx[i];
+    sle.main[i] = 2 * (dx[i] + dx[i + 1]);
+    sle.upper[i] = dx[i + 1];
+    sle.rhs[i] = 3.0 * (dy[i + 1] / dx[i + 1] - dy[i] / dx[i]);
+  }
+
+  // calculate coefficients
+  SolveTridiagonalSle(sle, coeffs_[C].data() + first_idx);
+
+  for (size_t i = 1; i < size; ++i) {
+    size_t idx = first_idx + i;
+    coeffs_[B][idx] =
+        dy[i] / dx[i] +
+        (2.0 * coeffs_[C][idx] + coeffs_[C][idx - 1]) / 3.0 * dx[i];
+    coeffs_[D][idx] = (coeffs_[C][idx] - coeffs_[C][idx - 1]) / (3.0 * dx[i]);
+  }
+}
+
+// Thomas algorithm, O(n) time and memory
+void CubicSpline::SolveTridiagonalSle(TridiagonalSle& sle, double* solution) {
+  size_t size = sle.main.size();
+
+  // forward elimination
+  for (size_t i = 1; i < size; ++i) {
+    double multiplier = sle.lower[i] / sle.main[i - 1];
+    sle.main[i] -= sle.upper[i - 1] * multiplier;
+    sle.rhs[i] -= sle.rhs[i - 1] * multiplier;
+  }
+
+  // back substitution
+  solution[size - 1] = sle.rhs.back() / sle.main.back();
+  for (size_t i = size - 1; i-- > 0;) {
+    solution[i] = (sle.rhs[i] - sle.upper[i] * solution[i + 1]) / sle.main[i];
+  }
+}
@@ -0,0 +1,61 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_CUBICSPLINE_H
+#define ALGORITHMIC_TRADING_MODEL_CUBICSPLINE_H
+
+#include <array>
+#include <vector>
+
+#include "scratch_arena.h"
+#include "time_series.h"
+
+// Natural cubic spline fitted once over a data set and then reused by every
+// point or batch query, and extended in place as new points arrive
+class CubicSpline {
+  enum CubicInterpolationCoefficients { A, B, C, D };
+
+  // only the three diagonals and the right-hand side are stored
+  struct TridiagonalSle {
+    explicit TridiagonalSle(size_t size)
+        : lower(size), main(size), upper(size), rhs(size) {}
+
+    ScratchVector<double> lower;
+    ScratchVector<double> main;
+    ScratchVector<double> upper;
+    ScratchVector<double> rhs;
+  };
+
+ public:
+  // the moved natural boundary changes every earlier second derivative by
+  // at most half as much as the next one, so after 64 knots the change is
+  // below double precision: the last segments of a spline only depend on
+  // this many knots before them
+  static const size_t kTailSize = 64;
+
+  CubicSpline() = default;
+  explicit CubicSpline(const TimeSeries& data);
+  // fitted over the data points [first_idx, last_idx) only
+  CubicSpline(const TimeSeries& data, size_t first_idx, size_t last_idx);
+
+  // refits over the data points [first_idx, last_idx), reusing the memory
+  // of the previous fit
+  void Fit(const TimeSeries& data, size_t first_idx, size_t last_idx);
+
+  // date must be later than the last knot; refits only the tail segments
+  void Append(time_t date, double price);
+
+  // the dates past the last knot are extrapolated linearly
+  double InterpolatePrice(time_t date, size_t pivot_date_idx) const;
+  // prices[i] at dates[i] from the segment pivot_date_idxs[i], vectorized
+  void InterpolatePrices(const time_t* dates, const size_t* pivot_date_idxs,
+                         size_t count, double* prices) const;
+
+ private:
+  // refits the knots after first_idx, keeping c at first_idx when it is not
+  // the first knot
+  void DefineInterpolationCoefficients(size_t first_idx);
+  static void SolveTridiagonalSle(TridiagonalSle& sle, double* solution);
+
+  std::vector<time_t> dates_;
+  std::array<std::vector<double>, 4> coeffs_;
+};
+
+#endif  // ALGORITHMIC_TRADING_MODEL_CUBICSPLINE_H
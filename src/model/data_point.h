@@ -1,6 +1,8 @@
 #ifndef ALGORITHMIC_TRADING_MODEL_DATAPOINT_H
 #define ALGORITHMIC_TRADING_MODEL_DATAPOINT_H
 
+#include <type_traits>
+
 #include "time_point.h"
 
 struct DataPoint {
@@ -10,4 +12,8 @@ struct DataPoint {
   double price;
 };
 
+static_assert(sizeof(DataPoint) == 16 &&
+                  std::is_trivially_copyable_v<DataPoint>,
+              "DataPoint must stay memcpy-able");
+
 #endif  // ALGORITHMIC_TRADING_MODEL_DATAPOINT_H
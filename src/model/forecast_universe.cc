@@ -0,0 +1,210 @@
+#include "forecast_universe.h"
+
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+bool ForecastUniverse::Load(const std::vector<std::string>& file_paths,
+                            ThreadPool& pool) {
+  error_message_.clear();
+  std::vector<std::pair<std::string, StockForecaster>> loaded;
+  std::vector<const std::string*> loaded_paths;
+  std::map<std::string, const std::string*> symbol_paths;
+  for (const std::string& file_path : file_paths) {
+    std::string symbol = fs::path(file_path).stem().string();
+    auto [it, is_new] = symbol_paths.emplace(symbol, &file_path);
+    if (!is_new) {
+      if (error_message_.empty()) {
+        error_message_ = "Duplicate symbol " + symbol + ": " + *it->second +
+                         " and " + file_path;
+      }
+      continue;
+    }
+    loaded.emplace_back(std::move(symbol), StockForecaster());
+    loaded_paths.push_back(&file_path);
+  }
+
+  // called from a pool worker, a blocking future.get() would hold it
+  std::vector<char> is_loaded(loaded.size());
+  ThreadPool::TaskGroup loads(pool);
+  for (size_t i = 0; i < loaded.size(); ++i) {
+    loads.Run([&, i]() {
+      is_loaded[i] = loaded[i].second.LoadData(*loaded_paths[i]);
+    });
+  }
+  loads.Wait();
+
+  for (size_t i = 0; i < loaded.size(); ++i) {
+    auto& [symbol, model] = loaded[i];
+    if (is_loaded[i]) {
+      models_.insert_or_assign(symbol, std::move(model));
+    } else if (error_message_.empty()) {
+      error_message_ = symbol + ": " + model.GetError();
+    }
+  }
+
+  return error_message_.empty();
+}
+
+bool ForecastUniverse::LoadDirectory(const std::string& dir_path,
+                                     ThreadPool& pool) {
+  std::vector<std::string> file_paths;
+  if (!ListFiles(dir_path, file_paths)) {
+    error_message_ = "Unable to read directory: " + dir_path;
+    return false;
+  }
+
+  return Load(file_paths, pool);
+}
+
+bool ForecastUniverse::ListFiles(const std::string& dir_path,
+                                 std::vector<std::string>& file_paths) {
+  std::error_code error;
+  for (const fs::directory_entry& entry :
+       fs::directory_iterator(dir_path, error)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".csv") {
+      file_paths.push_back(entry.path().string());
+    }
+  }
+
+  return !error;
+}
+
+bool ForecastUniverse::AddSymbol(const std::string& symbol,
+                                 const std::string& file_path) {
+  StockForecaster model;
+  if (!model.LoadData(file_path)) {
+    error_message_ = symbol + ": " + model.GetError();
+    return false;
+  }
+
+  models_.insert_or_assign(symbol, std::move(model));
+  return true;
+}
+
+void ForecastUniverse::FitModels(int degree, ThreadPool& pool) {
+  ForecastAll(
+      [degree](StockForecaster& model) {
+        model.FitModels(degree);
+        return true;
+      },
+      pool);
+}
+
+bool ForecastUniverse::InterpolatePriceByCubicSplineMethod(
+    const std::string& symbol, time_t date) {
+  StockForecaster* model = FindModel(symbol);
+  if (!model) {
+    return false;
+  }
+
+  if (!model->InterpolatePriceByCubicSplineMethod(date)) {
+    error_message_ = symbol + ": " + model->GetError();
+    return false;
+  }
+
+  forecast_price_ = model->GetForecastPrice();
+  return true;
+}
+
+bool ForecastUniverse::ApproximatePriceByLeastSquaresMethod(
+    const std::string& symbol, time_t date, int degree) {
+  StockForecaster* model = FindModel(symbol);
+  if (!model) {
+    return false;
+  }
+
+  if (!model->ApproximatePriceByLeastSquaresMethod(date, degree)) {
+    error_message_ = symbol + ": " + model->GetError();
+    return false;
+  }
+
+  forecast_price_ = model->GetForecastPrice();
+  return true;
+}
+
+bool ForecastUniverse::InterpolatePricesByCubicSplineMethod(
+    int dates_count, ThreadPool& pool) {
+  return ForecastAll(
+      [dates_count](StockForecaster& model) {
+        return model.InterpolatePricesByCubicSplineMethod(dates_count);
+      },
+      pool);
+}
+
+bool ForecastUniverse::ApproximatePricesByLeastSquaresMethod(
+    int dates_count, int future_days, int degree, ThreadPool& pool) {
+  return ForecastAll(
+      [dates_count, future_days, degree](StockForecaster& model) {
+        return model.ApproximatePricesByLeastSquaresMethod(
+            dates_count, future_days, degree);
+      },
+      pool);
+}
+
+std::vector<std::string> ForecastUniverse::GetSymbols() const {
+  std::vector<std::string> symbols;
+  symbols.reserve(models_.size());
+  for (const auto& [symbol, model] : models_) {
+    symbols.push_back(symbol);
+  }
+
+  return symbols;
+}
+
+size_t ForecastUniverse::size() const { return models_.size(); }
+
+const StockForecaster* ForecastUniverse::Find(
+    const std::string& symbol) const {
+  auto it = models_.find(symbol);
+  return it != models_.end() ? &it->second : nullptr;
+}
+
+const std::string& ForecastUniverse::GetError() const {
+  return error_message_;
+}
+
+double ForecastUniverse::GetForecastPrice() const { return forecast_price_; }
+
+const TimeSeries& ForecastUniverse::GetForecast(
+    const std::string& symbol) const {
+  static const TimeSeries kEmptyForecast;
+  const StockForecaster* model = Find(symbol);
+  return model ? model->GetForecast() : kEmptyForecast;
+}
+
+StockForecaster* ForecastUniverse::FindModel(const std::string& symbol) {
+  auto it = models_.find(symbol);
+  if (it == models_.end()) {
+    error_message_ = "Unknown symbol: " + symbol;
+    return nullptr;
+  }
+
+  return &it->second;
+}
+
+template <typename Forecast>
+bool ForecastUniverse::ForecastAll(Forecast forecast, ThreadPool& pool) {
+  std::vector<char> is_done(models_.size());
+  ThreadPool::TaskGroup forecasts(pool);
+  size_t i = 0;
+  for (auto& [symbol, model] : models_) {
+    StockForecaster* symbol_model = &model;
+    forecasts.Run([&forecast, &is_done, i, symbol_model]() {
+      is_done[i] = forecast(*symbol_model);
+    });
+    ++i;
+  }
+  forecasts.Wait();
+
+  error_message_.clear();
+  auto it = models_.begin();
+  for (char done : is_done) {
+    if (!done && error_message_.empty()) {
+      error_message_ = it->first + ": " + it->second.GetError();
+    }
+    ++it;
+  }
+
+  return error_message_.empty();
+}
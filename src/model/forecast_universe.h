@@ -0,0 +1,69 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_FORECASTUNIVERSE_H
+#define ALGORITHMIC_TRADING_MODEL_FORECASTUNIVERSE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "stockforecaster.h"
+#include "thread_pool.h"
+#include "time_series.h"
+
+// Many named series forecast side by side, one StockForecaster per symbol.
+// Loading, fitting and the batch forecasts run a task per symbol on the
+// pool, and the fitted models are kept, so the point queries by symbol only
+// evaluate them. The universe itself is not thread-safe: the calls that
+// take a pool parallelize inside and return once every symbol is done.
+class ForecastUniverse {
+ public:
+  // the symbol of a file is its name without the extension, and a symbol
+  // already held is reloaded; the files failing to load and the second file
+  // of a symbol are left out with an error
+  bool Load(const std::vector<std::string>& file_paths, ThreadPool& pool);
+  // every CSV file of the directory
+  bool LoadDirectory(const std::string& dir_path, ThreadPool& pool);
+  // the CSV files directly in the directory, in no particular order; false
+  // when it cannot be read
+  static bool ListFiles(const std::string& dir_path,
+                        std::vector<std::string>& file_paths);
+  bool AddSymbol(const std::string& symbol, const std::string& file_path);
+
+  // fits the spline and the least squares polynomial of every symbol, see
+  // StockForecaster::FitModels
+  void FitModels(int degree, ThreadPool& pool);
+
+  bool InterpolatePriceByCubicSplineMethod(const std::string& symbol,
+                                           time_t date);
+  bool ApproximatePriceByLeastSquaresMethod(const std::string& symbol,
+                                            time_t date, int degree);
+
+  // forecasts of every symbol, each kept by GetForecast(symbol); all the
+  // symbols are forecast even when some of them fail
+  bool InterpolatePricesByCubicSplineMethod(int dates_count,
+                                            ThreadPool& pool);
+  bool ApproximatePricesByLeastSquaresMethod(int dates_count, int future_days,
+                                             int degree, ThreadPool& pool);
+
+  std::vector<std::string> GetSymbols() const;  // in ascending order
+  size_t size() const;
+  // nullptr for a symbol not held
+  const StockForecaster* Find(const std::string& symbol) const;
+
+  // the first error of the last call, prefixed by its symbol
+  const std::string& GetError() const;
+  double GetForecastPrice() const;
+  // of the last batch forecast, empty for a symbol not held
+  const TimeSeries& GetForecast(const std::string& symbol) const;
+
+ private:
+  StockForecaster* FindModel(const std::string& symbol);
+  // runs forecast on every model in parallel and keeps the first error
+  template <typename Forecast>
+  bool ForecastAll(Forecast forecast, ThreadPool& pool);
+
+  std::map<std::string, StockForecaster> models_;
+  std::string error_message_;
+  double forecast_price_ = 0.0;
+};
+
+#endif  // ALGORITHMIC_TRADING_MODEL_FORECASTUNIVERSE_H
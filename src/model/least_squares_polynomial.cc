@@ -0,0 +1,71 @@
+#include "least_squares_polynomial.h"
+
+#include <algorithm>
+
+#include "batch_evaluator.h"
+#include "chebyshev.h"
+#include "lu_decomposition.h"
+#include "scratch_arena.h"
+
+LeastSquaresPolynomial::LeastSquaresPolynomial(const TimeSeries& data,
+                                               int degree) {
+  DefineApproximationCoefficients(data, degree);
+}
+
+double LeastSquaresPolynomial::ApproximatePrice(time_t date) const {
+  return SumChebyshevSeries(coeffs_, NormalizeDate(date));
+}
+
+void LeastSquaresPolynomial::ApproximatePrices(const time_t* dates,
+                                               size_t count,
+                                               double* prices) const {
+  EvaluateChebyshevSeries(coeffs_, center_, scale_, dates, count, prices);
+}
+
+int LeastSquaresPolynomial::GetDegree() const {
+  return static_cast<int>(coeffs_.size()) - 1;
+}
+
+double LeastSquaresPolynomial::GetConditionNumber() const {
+  return condition_number_;
+}
+
+void LeastSquaresPolynomial::DefineApproximationCoefficients(
+    const TimeSeries& data, int degree) {
+  coeffs_.clear();
+  if (data.empty()) {
+    return;
+  }
+
+  const std::vector<time_t>& dates = data.Dates();
+  const std::vector<double>& prices = data.Prices();
+  double min_date = dates.front();
+  double max_date = dates.back();
+  center_ = (min_date + max_date) / 2.0;
+  scale_ = max_date > min_date ? (max_date - min_date) / 2.0 : 1.0;
+
+  // sums of T(k) up to twice the degree make the whole Gram matrix
+  size_t size = std::min<size_t>(std::max(degree, 0) + 1, data.size());
+  std::vector<double> values(2 * size - 1);
+  ScratchArena::Scope scope;
+  ScratchVector<double> moments(values.size(), 0.0);
+  coeffs_.assign(size, 0.0);
+  for (size_t i = 0; i < data.size(); ++i) {
+    DefineChebyshevValues(NormalizeDate(dates[i]), values);
+    for (size_t k = 0; k < values.size(); ++k) {
+      moments[k] += values[k];
+    }
+    for (size_t k = 0; k < size; ++k) {
+      coeffs_[k] += values[k] * prices[i];
+    }
+  }
+
+  ScratchMatrix gram = DefineChebyshevGramMatrix(moments.data(), size);
+  LuDecomposition lu(gram);
+  lu.Solve(coeffs_.data());
+  condition_number_ = lu.GetConditionNumber();
+}
+
+double LeastSquaresPolynomial::NormalizeDate(time_t date) const {
+  return (date - center_) / scale_;
+}
@@ -0,0 +1,40 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_LEASTSQUARESPOLYNOMIAL_H
+#define ALGORITHMIC_TRADING_MODEL_LEASTSQUARESPOLYNOMIAL_H
+
+#include <vector>
+
+#include "time_series.h"
+
+// Least squares polynomial over a time axis centered and scaled to [-1, 1].
+// It is fitted and kept in the Chebyshev basis, whose normal equations stay
+// well-conditioned there even at high degrees, and evaluated by Clenshaw's
+// recurrence. The sums of the normal equations take O(n * degree) and their
+// LU solve O(degree^3).
+class LeastSquaresPolynomial {
+ public:
+  LeastSquaresPolynomial() = default;
+  LeastSquaresPolynomial(const TimeSeries& data, int degree);
+
+  double ApproximatePrice(time_t date) const;
+  // prices[i] at dates[i], vectorized
+  void ApproximatePrices(const time_t* dates, size_t count,
+                         double* prices) const;
+
+  // a polynomial of degree k is only defined by more than k data points, so
+  // with fewer the degree fitted is below the one asked for
+  int GetDegree() const;
+  // of the normal equations solved, estimated in the 1-norm, infinity when
+  // they are singular; the fit loses about log10 of it of its 16 digits
+  double GetConditionNumber() const;
+
+ private:
+  void DefineApproximationCoefficients(const TimeSeries& data, int degree);
+  double NormalizeDate(time_t date) const;
+
+  double center_ = 0.0;
+  double scale_ = 1.0;
+  std::vector<double> coeffs_;  // of T(k) of the normalized time
+  double condition_number_ = 1.0;
+};
+
+#endif  // ALGORITHMIC_TRADING_MODEL_LEASTSQUARESPOLYNOMIAL_H
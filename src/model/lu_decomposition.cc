@@ -0,0 +1,154 @@
+#include "lu_decomposition.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "condition_number.h"
+
+namespace {
+
+// y -= alpha * x over contiguous rows, left to the compiler to vectorize
+inline void SubtractScaledRow(double alpha, const double* x, double* y,
+                              size_t count) {
+  for (size_t j = 0; j < count; ++j) {
+    y[j] -= alpha * x[j];
+  }
+}
+
+}  // namespace
+
+LuDecomposition::LuDecomposition(ScratchMatrix& matrix)
+    : lu_(matrix), pivots_(matrix.rows_count()) {
+  size_t size = lu_.rows_count();
+  for (size_t j = 0; j < size; ++j) {
+    double column_norm = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+      column_norm += std::fabs(lu_[i][j]);
+    }
+    norm_ = std::max(norm_, column_norm);
+  }
+
+  for (size_t first_col = 0; first_col < size; first_col += kBlockSize) {
+    size_t last_col = std::min(first_col + kBlockSize, size);
+    FactorPanel(first_col, last_col);
+    UpdateTrailingMatrix(first_col, last_col);
+  }
+}
+
+void LuDecomposition::Solve(double* rhs) const {
+  size_t size = lu_.rows_count();
+  for (size_t k = 0; k < size; ++k) {
+    std::swap(rhs[k], rhs[pivots_[k]]);
+  }
+
+  // L * y = P * rhs, L has a unit diagonal
+  for (size_t i = 0; i < size; ++i) {
+    const double* row = lu_[i];
+    double value = rhs[i];
+    for (size_t j = 0; j < i; ++j) {
+      value -= row[j] * rhs[j];
+    }
+    rhs[i] = value;
+  }
+
+  // U * x = y
+  for (size_t i = size; i-- > 0;) {
+    const double* row = lu_[i];
+    double value = rhs[i];
+    for (size_t j = i + 1; j < size; ++j) {
+      value -= row[j] * rhs[j];
+    }
+    rhs[i] = row[i] != 0.0 ? value / row[i] : 0.0;
+  }
+}
+
+// A^T = U^T * L^T * P, solved by rows of U and L taken as columns
+void LuDecomposition::SolveTransposed(double* rhs) const {
+  size_t size = lu_.rows_count();
+
+  // U^T * y = rhs
+  for (size_t i = 0; i < size; ++i) {
+    const double* row = lu_[i];
+    rhs[i] = row[i] != 0.0 ? rhs[i] / row[i] : 0.0;
+    SubtractScaledRow(rhs[i], row + i + 1, rhs + i + 1, size - i - 1);
+  }
+
+  // L^T * z = y
+  for (size_t i = size; i-- > 0;) {
+    SubtractScaledRow(rhs[i], lu_[i], rhs, i);
+  }
+
+  for (size_t k = size; k-- > 0;) {
+    std::swap(rhs[k], rhs[pivots_[k]]);
+  }
+}
+
+bool LuDecomposition::IsSingular() const { return is_singular_; }
+
+double LuDecomposition::GetConditionNumber() const {
+  if (is_singular_) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  return norm_ * EstimateInverseNorm(
+                     lu_.rows_count(), [this](double* x) { Solve(x); },
+                     [this](double* x) { SolveTransposed(x); });
+}
+
+// unblocked elimination of the columns [first_col, last_col) below the
+// diagonal, the swaps are applied to whole rows
+void LuDecomposition::FactorPanel(size_t first_col, size_t last_col) {
+  size_t size = lu_.rows_count();
+  double tolerance = DefinePivotTolerance(size, norm_);
+  for (size_t k = first_col; k < last_col; ++k) {
+    size_t pivot = k;
+    for (size_t i = k + 1; i < size; ++i) {
+      pivot = std::fabs(lu_[i][k]) > std::fabs(lu_[pivot][k]) ? i : pivot;
+    }
+    pivots_[k] = pivot;
+    lu_.SwapRows(k, pivot);
+
+    // a column of rounding noise is dropped whole, which leaves the rest of
+    // the matrix as it is and its direction at zero in the solves
+    const double* pivot_row = lu_[k];
+    if (!(std::fabs(pivot_row[k]) > tolerance)) {
+      is_singular_ = true;
+      for (size_t i = k; i < size; ++i) {
+        lu_[i][k] = 0.0;
+      }
+      continue;
+    }
+
+    for (size_t i = k + 1; i < size; ++i) {
+      double* row = lu_[i];
+      row[k] /= pivot_row[k];
+      SubtractScaledRow(row[k], pivot_row + k + 1, row + k + 1,
+                        last_col - k - 1);
+    }
+  }
+}
+
+// the rows of U right of the panel, then A22 -= L21 * U12
+void LuDecomposition::UpdateTrailingMatrix(size_t first_col,
+                                           size_t last_col) {
+  size_t size = lu_.rows_count();
+  size_t count = size - last_col;
+  if (count == 0) {
+    return;
+  }
+
+  for (size_t i = first_col + 1; i < last_col; ++i) {
+    double* row = lu_[i];
+    for (size_t k = first_col; k < i; ++k) {
+      SubtractScaledRow(row[k], lu_[k] + last_col, row + last_col, count);
+    }
+  }
+
+  for (size_t i = last_col; i < size; ++i) {
+    double* row = lu_[i];
+    for (size_t k = first_col; k < last_col; ++k) {
+      SubtractScaledRow(row[k], lu_[k] + last_col, row + last_col, count);
+    }
+  }
+}
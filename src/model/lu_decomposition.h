@@ -0,0 +1,43 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_LUDECOMPOSITION_H
+#define ALGORITHMIC_TRADING_MODEL_LUDECOMPOSITION_H
+
+#include "matrix.h"
+#include "scratch_arena.h"
+
+// LU factorization with partial pivoting, P * A = L * U, of a dense square
+// matrix. The matrix is factored in place in panels of kBlockSize columns:
+// a panel is eliminated column by column, and the rest of the matrix is then
+// updated by the whole panel at once, row by row over contiguous memory, so
+// the rows of U it reads stay in cache while every row below goes by.
+//
+// Lives on scratch memory: construct it inside a ScratchArena::Scope, and
+// keep the matrix alive and untouched for as long as it is used.
+class LuDecomposition {
+ public:
+  static const size_t kBlockSize = 32;
+
+  explicit LuDecomposition(ScratchMatrix& matrix);
+
+  // overwrites rhs, of the size of the matrix, with the solution of
+  // A * x = rhs; for a singular matrix the directions without a pivot are
+  // left at zero, and a pivot within DefinePivotTolerance counts as none
+  void Solve(double* rhs) const;
+  // the same for A^T * x = rhs
+  void SolveTransposed(double* rhs) const;
+
+  bool IsSingular() const;
+  // estimate of ||A|| * ||A^-1|| in the 1-norm, see EstimateInverseNorm;
+  // infinity for a singular matrix
+  double GetConditionNumber() const;
+
+ private:
+  void FactorPanel(size_t first_col, size_t last_col);
+  void UpdateTrailingMatrix(size_t first_col, size_t last_col);
+
+  ScratchMatrix& lu_;
+  ScratchVector<size_t> pivots_;  // row swapped with row k at step k
+  double norm_ = 0.0;             // 1-norm of A
+  bool is_singular_ = false;
+};
+
+#endif  // ALGORITHMIC_TRADING_MODEL_LUDECOMPOSITION_H
@@ -0,0 +1,67 @@
+#include "mapped_file.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <sstream>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+
+MappedFile::MappedFile(const std::string& file_path) {
+  int fd = open(file_path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return;
+  }
+
+  struct stat file_stat {};
+  if (fstat(fd, &file_stat) == 0) {
+    size_ = file_stat.st_size;
+    if (size_ == 0) {
+      is_open_ = true;
+    } else {
+      void* address = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (address != MAP_FAILED) {
+        madvise(address, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(address);
+        is_open_ = true;
+      }
+    }
+  }
+
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& file_path) {
+  std::ifstream ifs(file_path, std::ios::binary);
+  if (ifs.is_open()) {
+    std::ostringstream ss;
+    ss << ifs.rdbuf();
+    buffer_ = ss.str();
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    is_open_ = true;
+  }
+}
+
+MappedFile::~MappedFile() {}
+
+#endif
+
+bool MappedFile::IsOpen() const { return is_open_; }
+
+const char* MappedFile::Data() const { return data_; }
+
+size_t MappedFile::Size() const { return size_; }
@@ -0,0 +1,26 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_MAPPEDFILE_H
+#define ALGORITHMIC_TRADING_MODEL_MAPPEDFILE_H
+
+#include <string>
+
+// Read-only view of a whole file. The file is memory-mapped where the
+// platform allows it and read into a buffer otherwise.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& file_path);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  bool IsOpen() const;
+  const char* Data() const;
+  size_t Size() const;
+
+ private:
+  bool is_open_ = false;
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  std::string buffer_;  // used only when mmap is unavailable
+};
+
+#endif  // ALGORITHMIC_TRADING_MODEL_MAPPEDFILE_H
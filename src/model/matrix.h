@@ -0,0 +1,71 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_MATRIX_H
+#define ALGORITHMIC_TRADING_MODEL_MATRIX_H
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "scratch_arena.h"
+
+// Dense row-major matrix in one contiguous buffer. matrix[i] points at row
+// i, so matrix[i][j] reads like the nested vectors it replaces, but the rows
+// share one allocation and lie next to each other in memory.
+template <typename Allocator = std::allocator<double>>
+class BasicMatrix {
+ public:
+  BasicMatrix() = default;
+  BasicMatrix(size_t rows_count, size_t cols_count)
+      : rows_count_(rows_count),
+        cols_count_(cols_count),
+        values_(rows_count * cols_count, 0.0) {}
+
+  // copies between matrices of different allocators
+  template <typename OtherAllocator>
+  explicit BasicMatrix(const BasicMatrix<OtherAllocator>& other)
+      : rows_count_(other.rows_count()),
+        cols_count_(other.cols_count()),
+        values_(other.data(), other.data() + other.size()) {}
+  template <typename OtherAllocator>
+  BasicMatrix& operator=(const BasicMatrix<OtherAllocator>& other) {
+    rows_count_ = other.rows_count();
+    cols_count_ = other.cols_count();
+    values_.assign(other.data(), other.data() + other.size());
+    return *this;
+  }
+
+  // reshapes to zeros, reusing the buffer when it is large enough
+  void Assign(size_t rows_count, size_t cols_count) {
+    rows_count_ = rows_count;
+    cols_count_ = cols_count;
+    values_.assign(rows_count * cols_count, 0.0);
+  }
+
+  double* operator[](size_t row) { return values_.data() + row * cols_count_; }
+  const double* operator[](size_t row) const {
+    return values_.data() + row * cols_count_;
+  }
+
+  void SwapRows(size_t first_row, size_t second_row) {
+    if (first_row != second_row) {
+      std::swap_ranges((*this)[first_row], (*this)[first_row] + cols_count_,
+                       (*this)[second_row]);
+    }
+  }
+
+  size_t rows_count() const { return rows_count_; }
+  size_t cols_count() const { return cols_count_; }
+  size_t size() const { return values_.size(); }
+  double* data() { return values_.data(); }
+  const double* data() const { return values_.data(); }
+
+ private:
+  size_t rows_count_ = 0;
+  size_t cols_count_ = 0;
+  std::vector<double, Allocator> values_;
+};
+
+using Matrix = BasicMatrix<>;
+// temporaries of a fit, see ScratchArena
+using ScratchMatrix = BasicMatrix<ScratchAllocator<double>>;
+
+#endif  // ALGORITHMIC_TRADING_MODEL_MATRIX_H
@@ -0,0 +1,207 @@
+#include "model_selector.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "rolling_least_squares.h"
+
+namespace {
+
+// error sums of one window size, indexed by degree * horizons + horizon
+struct ErrorSums {
+  std::vector<double> squared_errors;
+  std::vector<double> absolute_errors;
+  std::vector<double> relative_errors;
+  std::vector<bool> is_failed;  // by degree, once a fit is not defined
+};
+
+// forecasts the data points [first_target_idx, last_target_idx) with every
+// degree and horizon
+ErrorSums SumErrors(const TimeSeries& data, int window_size,
+                    const std::vector<int>& degrees,
+                    const std::vector<int>& horizons, size_t first_target_idx,
+                    size_t last_target_idx) {
+  size_t horizons_count = horizons.size();
+  ErrorSums sums{std::vector<double>(degrees.size() * horizons_count),
+                 std::vector<double>(degrees.size() * horizons_count),
+                 std::vector<double>(degrees.size() * horizons_count),
+                 std::vector<bool>(degrees.size())};
+
+  int max_degree = *std::max_element(degrees.begin(), degrees.end());
+  int min_horizon = *std::min_element(horizons.begin(), horizons.end());
+  int max_horizon = *std::max_element(horizons.begin(), horizons.end());
+
+  size_t first_idx = first_target_idx - max_horizon;
+  RollingLeastSquares polynomial(data, max_degree, first_idx + 1 - window_size);
+  for (int i = 0; i < window_size; ++i) {
+    polynomial.PushBack();
+  }
+
+  const std::vector<time_t>& dates = data.Dates();
+  const std::vector<double>& prices = data.Prices();
+  Matrix fits;
+  for (size_t i = first_idx; i + min_horizon < last_target_idx; ++i) {
+    if (i > first_idx) {
+      polynomial.PopFront();
+      polynomial.PushBack();
+    }
+
+    size_t fitted_count = polynomial.FitDegrees(fits);
+    for (size_t d = 0; d < degrees.size(); ++d) {
+      if (static_cast<size_t>(degrees[d]) >= fitted_count) {
+        sums.is_failed[d] = true;
+        continue;
+      }
+
+      for (size_t h = 0; h < horizons_count; ++h) {
+        size_t target_idx = i + horizons[h];
+        if (target_idx < first_target_idx || target_idx >= last_target_idx) {
+          continue;
+        }
+
+        double price = prices[target_idx];
+        double error =
+            polynomial.ApproximatePrice(fits, degrees[d], dates[target_idx]) -
+            price;
+        size_t idx = d * horizons_count + h;
+        sums.squared_errors[idx] += error * error;
+        sums.absolute_errors[idx] += std::fabs(error);
+        sums.relative_errors[idx] +=
+            price != 0.0 ? std::fabs(error / price) : 0.0;
+      }
+    }
+  }
+
+  return sums;
+}
+
+bool IsValid(const std::vector<int>& values, int min_value) {
+  return !values.empty() &&
+         *std::min_element(values.begin(), values.end()) >= min_value;
+}
+
+}  // namespace
+
+bool ModelSelector::Select(const TimeSeries& data,
+                           const ModelSelectionGrid& grid, ThreadPool& pool) {
+  best_.clear();
+  scores_.clear();
+  if (!IsValid(grid.degrees, 0) || !IsValid(grid.window_sizes, 2) ||
+      !IsValid(grid.horizons, 1)) {
+    error_message_ = "Invalid selection grid";
+    return false;
+  }
+
+  // the first data point every setting can forecast
+  int max_window_size =
+      *std::max_element(grid.window_sizes.begin(), grid.window_sizes.end());
+  int max_horizon =
+      *std::max_element(grid.horizons.begin(), grid.horizons.end());
+  size_t first_target_idx = max_window_size - 1 + max_horizon;
+  if (first_target_idx >= data.size()) {
+    error_message_ = "Not enough data for the window and the horizon";
+    return false;
+  }
+  size_t targets_count = data.size() - first_target_idx;
+
+  // chunks refill their window first, so they are kept longer than it
+  std::vector<size_t> first_chunk_idxs;
+  std::vector<ErrorSums> chunk_sums;
+  ThreadPool::TaskGroup chunks(pool);
+  for (int window_size : grid.window_sizes) {
+    size_t chunks_count =
+        (pool.GetThreadsCount() + grid.window_sizes.size() - 1) /
+        grid.window_sizes.size();
+    chunks_count = std::clamp<size_t>(targets_count / window_size, 1,
+                                      std::max<size_t>(chunks_count, 1));
+    first_chunk_idxs.push_back(chunk_sums.size());
+    chunk_sums.resize(chunk_sums.size() + chunks_count);
+  }
+  first_chunk_idxs.push_back(chunk_sums.size());
+
+  for (size_t w = 0; w < grid.window_sizes.size(); ++w) {
+    size_t chunks_count = first_chunk_idxs[w + 1] - first_chunk_idxs[w];
+    for (size_t chunk = 0; chunk < chunks_count; ++chunk) {
+      size_t first_idx =
+          first_target_idx + targets_count * chunk / chunks_count;
+      size_t last_idx =
+          first_target_idx + targets_count * (chunk + 1) / chunks_count;
+      ErrorSums* sums = &chunk_sums[first_chunk_idxs[w] + chunk];
+      int window_size = grid.window_sizes[w];
+      chunks.Run([&data, &grid, sums, window_size, first_idx, last_idx]() {
+        *sums = SumErrors(data, window_size, grid.degrees, grid.horizons,
+                          first_idx, last_idx);
+      });
+    }
+  }
+  chunks.Wait();
+
+  for (size_t w = 0; w < grid.window_sizes.size(); ++w) {
+    ErrorSums& sums = chunk_sums[first_chunk_idxs[w]];
+    for (size_t chunk = first_chunk_idxs[w] + 1;
+         chunk < first_chunk_idxs[w + 1]; ++chunk) {
+      const ErrorSums& next_sums = chunk_sums[chunk];
+      for (size_t idx = 0; idx < sums.squared_errors.size(); ++idx) {
+        sums.squared_errors[idx] += next_sums.squared_errors[idx];
+        sums.absolute_errors[idx] += next_sums.absolute_errors[idx];
+        sums.relative_errors[idx] += next_sums.relative_errors[idx];
+      }
+      for (size_t d = 0; d < sums.is_failed.size(); ++d) {
+        sums.is_failed[d] = sums.is_failed[d] || next_sums.is_failed[d];
+      }
+    }
+
+    for (size_t d = 0; d < grid.degrees.size(); ++d) {
+      if (sums.is_failed[d]) {
+        continue;
+      }
+
+      for (size_t h = 0; h < grid.horizons.size(); ++h) {
+        size_t idx = d * grid.horizons.size() + h;
+        ModelScore score;
+        score.degree = grid.degrees[d];
+        score.window_size = grid.window_sizes[w];
+        score.horizon = grid.horizons[h];
+        score.forecasts_count = targets_count;
+        score.rmse = std::sqrt(sums.squared_errors[idx] / targets_count);
+        score.mae = sums.absolute_errors[idx] / targets_count;
+        score.mape = sums.relative_errors[idx] / targets_count;
+        scores_.push_back(score);
+      }
+    }
+  }
+
+  if (scores_.empty()) {
+    error_message_ = "No setting of the grid could be fitted";
+    return false;
+  }
+
+  std::vector<int> horizon_ranks(max_horizon + 1);
+  for (size_t h = grid.horizons.size(); h-- > 0;) {
+    horizon_ranks[grid.horizons[h]] = h;
+  }
+  std::stable_sort(scores_.begin(), scores_.end(),
+                   [&horizon_ranks](const ModelScore& a, const ModelScore& b) {
+                     int a_rank = horizon_ranks[a.horizon];
+                     int b_rank = horizon_ranks[b.horizon];
+                     return a_rank != b_rank ? a_rank < b_rank
+                                             : a.rmse < b.rmse;
+                   });
+  for (const ModelScore& score : scores_) {
+    if (best_.empty() || best_.back().horizon != score.horizon) {
+      best_.push_back(score);
+    }
+  }
+
+  return true;
+}
+
+const std::vector<ModelScore>& ModelSelector::GetBest() const {
+  return best_;
+}
+
+const std::vector<ModelScore>& ModelSelector::GetScores() const {
+  return scores_;
+}
+
+const std::string& ModelSelector::GetError() const { return error_message_; }
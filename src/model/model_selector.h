@@ -0,0 +1,50 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_MODELSELECTOR_H
+#define ALGORITHMIC_TRADING_MODEL_MODELSELECTOR_H
+
+#include <string>
+#include <vector>
+
+#include "thread_pool.h"
+#include "time_series.h"
+
+// least squares settings to choose from, every combination is scored
+struct ModelSelectionGrid {
+  std::vector<int> degrees = {1, 2, 3, 4, 5, 6};
+  std::vector<int> window_sizes = {60, 120, 250};
+  std::vector<int> horizons = {1, 5};
+};
+
+struct ModelScore {
+  int degree = 0;
+  int window_size = 0;
+  int horizon = 0;
+  size_t forecasts_count = 0;
+  double rmse = 0.0;
+  double mae = 0.0;
+  double mape = 0.0;  // mean absolute error as a fraction of the price
+};
+
+// Walk-forward cross-validation of the least squares settings: every
+// setting forecasts the same data points, each from the window_size points
+// horizon points before it, so the errors of all settings are comparable.
+// Each window size slides a single RollingLeastSquares of the highest degree
+// whose sums serve all degrees, and the data is cut into chunks run in
+// parallel on the pool.
+class ModelSelector {
+ public:
+  bool Select(const TimeSeries& data, const ModelSelectionGrid& grid,
+              ThreadPool& pool);
+
+  // the setting of the lowest RMSE for each horizon of the grid, in order
+  const std::vector<ModelScore>& GetBest() const;
+  // every setting that could be fitted, by horizon, then by RMSE
+  const std::vector<ModelScore>& GetScores() const;
+  const std::string& GetError() const;
+
+ private:
+  std::vector<ModelScore> best_;
+  std::vector<ModelScore> scores_;
+  std::string error_message_;
+};
+
+#endif  // ALGORITHMIC_TRADING_MODEL_MODELSELECTOR_H
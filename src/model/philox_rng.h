@@ -0,0 +1,53 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_PHILOXRNG_H
+#define ALGORITHMIC_TRADING_MODEL_PHILOXRNG_H
+
+#include <array>
+#include <cstdint>
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel Random
+// Numbers: As Easy as 1, 2, 3"). The random numbers are a keyed bijection
+// of a counter, so there is no state to share or to split between threads:
+// any number of the stream is computed straight from its position, and a
+// simulation gives the same paths on any number of threads.
+class PhiloxRng {
+ public:
+  using Counter = std::array<uint32_t, 4>;
+
+  explicit PhiloxRng(uint64_t seed)
+      : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)} {}
+
+  // four independent uniform 32-bit numbers of the counter
+  Counter operator()(Counter counter) const {
+    uint32_t key0 = key_[0], key1 = key_[1];
+    for (int round = 0; round < 10; ++round) {
+      if (round > 0) {
+        key0 += kWeyl0;
+        key1 += kWeyl1;
+      }
+      uint64_t product0 = static_cast<uint64_t>(kMultiplier0) * counter[0];
+      uint64_t product1 = static_cast<uint64_t>(kMultiplier1) * counter[2];
+      counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key0,
+                 static_cast<uint32_t>(product1),
+                 static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key1,
+                 static_cast<uint32_t>(product0)};
+    }
+
+    return counter;
+  }
+
+  // uniform on [0, 1) with the full 53 bits of a double
+  static double ToUniform(uint32_t high, uint32_t low) {
+    uint64_t bits = (static_cast<uint64_t>(high) << 32 | low) >> 11;
+    return bits * (1.0 / (UINT64_C(1) << 53));
+  }
+
+ private:
+  static const uint32_t kMultiplier0 = 0xD2511F53;
+  static const uint32_t kMultiplier1 = 0xCD9E8D57;
+  static const uint32_t kWeyl0 = 0x9E3779B9;  // golden ratio
+  static const uint32_t kWeyl1 = 0xBB67AE85;  // sqrt(3) - 1
+
+  std::array<uint32_t, 2> key_;
+};
+
+#endif  // ALGORITHMIC_TRADING_MODEL_PHILOXRNG_H
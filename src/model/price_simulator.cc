@@ -0,0 +1,228 @@
+#include "price_simulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "philox_rng.h"
+
+namespace {
+
+const double kSecondsPerDay = 24 * 60 * 60;
+const double kTwoPi = 6.283185307179586;
+
+// pairs of paths drawn together, a Philox block gives two shocks
+const size_t kBlockSize = 64;
+
+}  // namespace
+
+bool PriceSimulator::Fit(const TimeSeries& data,
+                         const std::vector<double>& trend) {
+  if (data.size() < 3 || trend.size() != data.size()) {
+    error_message_ = "Not enough data to fit the volatility";
+    return false;
+  }
+
+  std::vector<double> deviations(data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    double price = data.Prices()[i];
+    if (!(price > 0.0 && trend[i] > 0.0)) {
+      error_message_ =
+          "Prices and the trend must stay positive over the data, lower "
+          "the degree";
+      return false;
+    }
+    deviations[i] = std::log(price / trend[i]);
+  }
+
+  // the increments standardized to one day, less their drift
+  const std::vector<time_t>& dates = data.Dates();
+  double total_days = (dates.back() - dates.front()) / kSecondsPerDay;
+  double drift = (deviations.back() - deviations.front()) / total_days;
+  shocks_.clear();
+  double squares_sum = 0.0;
+  for (size_t i = 1; i < data.size(); ++i) {
+    double days = (dates[i] - dates[i - 1]) / kSecondsPerDay;
+    if (days > 0.0) {
+      double increment = deviations[i] - deviations[i - 1];
+      shocks_.push_back((increment - drift * days) / std::sqrt(days));
+      squares_sum += shocks_.back() * shocks_.back();
+    }
+  }
+
+  if (shocks_.size() < 2) {
+    error_message_ = "Not enough data to fit the volatility";
+    return false;
+  }
+
+  volatility_ = std::sqrt(squares_sum / (shocks_.size() - 1));
+  start_deviation_ = deviations.back();
+  return true;
+}
+
+bool PriceSimulator::Simulate(const std::vector<time_t>& dates,
+                              const std::vector<double>& trend,
+                              const SimulationSettings& settings,
+                              ThreadPool& pool, std::vector<TimeSeries>& bands,
+                              const ProgressCallback& report_progress) {
+  const std::vector<double>& percentiles = settings.percentiles;
+  if (shocks_.empty()) {
+    error_message_ = "First you need to fit the simulation";
+    return false;
+  }
+  if (dates.size() < 2 || trend.size() != dates.size() ||
+      settings.paths_count == 0 || percentiles.empty()) {
+    error_message_ = "Invalid simulation settings";
+    return false;
+  }
+  if (!std::is_sorted(percentiles.begin(), percentiles.end()) ||
+      percentiles.front() < 0.0 || percentiles.back() > 100.0) {
+    error_message_ = "Percentiles must ascend within [0, 100]";
+    return false;
+  }
+
+  // the shocks are compensated for E[exp(shock)], exactly for the drawn ones
+  double step_days = (dates[1] - dates[0]) / kSecondsPerDay;
+  double compensation = 0.0;
+  if (settings.model == SimulationModel::kGeometricBrownianMotion) {
+    compensation = volatility_ * volatility_ * step_days / 2.0;
+  } else {
+    double sum = 0.0;
+    for (double shock : shocks_) {
+      sum += std::exp(shock * std::sqrt(step_days));
+    }
+    compensation = std::log(sum / shocks_.size());
+  }
+
+  size_t steps_count = dates.size();
+  size_t bands_count = percentiles.size();
+  std::vector<double> selected(steps_count * bands_count, start_deviation_);
+  std::vector<double> deviations(settings.paths_count, start_deviation_);
+
+  // a step is selected from a copy while the next one is simulated
+  std::vector<double> copies[2];
+  ThreadPool::TaskGroup selections[2] = {ThreadPool::TaskGroup(pool),
+                                         ThreadPool::TaskGroup(pool)};
+  auto wait_selections = [&selections]() {
+    for (ThreadPool::TaskGroup& selection : selections) {
+      selection.Wait();
+    }
+  };
+
+  ThreadPool::TaskGroup chunks(pool);
+  for (size_t step = 1; step < steps_count; ++step) {
+    if (report_progress && !report_progress(step - 1, steps_count - 1)) {
+      wait_selections();
+      error_message_ = "Simulation was cancelled";
+      return false;
+    }
+
+    for (size_t first = 0; first < deviations.size(); first += kChunkSize) {
+      size_t last = std::min(first + kChunkSize, deviations.size());
+      chunks.Run([&, step, first, last]() {
+        AdvancePaths(settings, step, step_days, compensation, first, last,
+                     deviations.data());
+      });
+    }
+    chunks.Wait();
+
+    ThreadPool::TaskGroup& selection = selections[step % 2];
+    std::vector<double>& copy = copies[step % 2];
+    selection.Wait();
+    copy = deviations;
+    double* step_selected = selected.data() + step * bands_count;
+    selection.Run([&percentiles, &copy, step_selected]() {
+      SelectPercentiles(percentiles, copy, step_selected);
+    });
+  }
+  wait_selections();
+
+  bands.assign(bands_count, TimeSeries());
+  for (size_t j = 0; j < bands_count; ++j) {
+    bands[j].Reserve(steps_count);
+    for (size_t step = 0; step < steps_count; ++step) {
+      double deviation = selected[step * bands_count + j];
+      bands[j].Append(dates[step], trend[step] * std::exp(deviation));
+    }
+  }
+
+  return true;
+}
+
+double PriceSimulator::GetVolatility() const { return volatility_; }
+
+const std::string& PriceSimulator::GetError() const { return error_message_; }
+
+// the random bits of a block are drawn first and shaped into shocks after,
+// both loops over plain arrays that the compiler can vectorize
+void PriceSimulator::AdvancePaths(const SimulationSettings& settings,
+                                  size_t step, double step_days,
+                                  double compensation, size_t first_path,
+                                  size_t last_path,
+                                  double* deviations) const {
+  PhiloxRng rng(settings.seed);
+  double step_scale = std::sqrt(step_days);
+  double step_volatility = volatility_ * step_scale;
+  uint64_t shocks_count = shocks_.size();
+
+  uint32_t bits[4][kBlockSize];
+  double shocks[2 * kBlockSize];
+  for (size_t first = first_path; first < last_path;
+       first += 2 * kBlockSize) {
+    size_t pairs_count = std::min((last_path - first + 1) / 2, kBlockSize);
+    uint64_t first_pair = first / 2;
+    for (size_t k = 0; k < pairs_count; ++k) {
+      uint64_t pair = first_pair + k;
+      PhiloxRng::Counter random =
+          rng({static_cast<uint32_t>(pair), static_cast<uint32_t>(pair >> 32),
+               static_cast<uint32_t>(step), 0});
+      for (size_t r = 0; r < 4; ++r) {
+        bits[r][k] = random[r];
+      }
+    }
+
+    if (settings.model == SimulationModel::kGeometricBrownianMotion) {
+      // Box-Muller, 1 - u keeps the logarithm finite
+      for (size_t k = 0; k < pairs_count; ++k) {
+        double radius =
+            step_volatility *
+            std::sqrt(-2.0 *
+                      std::log(1.0 - PhiloxRng::ToUniform(bits[0][k],
+                                                          bits[1][k])));
+        double angle = kTwoPi * PhiloxRng::ToUniform(bits[2][k], bits[3][k]);
+        shocks[2 * k] = radius * std::cos(angle);
+        shocks[2 * k + 1] = radius * std::sin(angle);
+      }
+    } else {
+      for (size_t k = 0; k < pairs_count; ++k) {
+        shocks[2 * k] = step_scale * shocks_[(bits[0][k] * shocks_count) >> 32];
+        shocks[2 * k + 1] =
+            step_scale * shocks_[(bits[2][k] * shocks_count) >> 32];
+      }
+    }
+
+    size_t count = std::min(2 * pairs_count, last_path - first);
+    for (size_t k = 0; k < count; ++k) {
+      deviations[first + k] += shocks[k] - compensation;
+    }
+  }
+}
+
+// nth_element for each percentile in turn over the part above the last,
+// interpolated linearly between the neighbouring ranks
+void PriceSimulator::SelectPercentiles(const std::vector<double>& percentiles,
+                                       std::vector<double>& deviations,
+                                       double* selected) {
+  auto first = deviations.begin();
+  for (size_t j = 0; j < percentiles.size(); ++j) {
+    double rank = percentiles[j] / 100.0 * (deviations.size() - 1);
+    auto lower = deviations.begin() + static_cast<size_t>(rank);
+    std::nth_element(first, lower, deviations.end());
+    double value = *lower;
+    if (lower + 1 != deviations.end()) {
+      double upper = *std::min_element(lower + 1, deviations.end());
+      value += (rank - std::floor(rank)) * (upper - value);
+    }
+    selected[j] = value;
+    first = lower;
+  }
+}
@@ -0,0 +1,69 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_PRICESIMULATOR_H
+#define ALGORITHMIC_TRADING_MODEL_PRICESIMULATOR_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "thread_pool.h"
+#include "time_series.h"
+
+enum class SimulationModel { kGeometricBrownianMotion, kBootstrap };
+
+struct SimulationSettings {
+  SimulationModel model = SimulationModel::kGeometricBrownianMotion;
+  size_t paths_count = 100'000;
+  uint64_t seed = 0;
+  std::vector<double> percentiles = {5.0, 25.0, 50.0, 75.0, 95.0};
+};
+
+// Monte Carlo price paths around a trend. A price is the trend times
+// exp(x), and the log deviation x walks on from that of the last data point
+// by independent shocks: normal ones of the volatility of the data around
+// the trend (geometric Brownian motion), or the standardized shocks of the
+// data itself drawn with replacement (bootstrap), which keeps their fat
+// tails. Either way the shocks are compensated so that the expected price
+// follows the trend scaled by the last deviation.
+//
+// The paths advance step by step over all of them, a chunk per task, and
+// only the current step is kept: the percentiles of a step are selected
+// while the next one is simulated. Path i draws its shocks from the Philox
+// counter (i / 2, step), so the bands do not depend on the threads.
+class PriceSimulator {
+ public:
+  // receives the done and the total steps, returns false to cancel
+  using ProgressCallback = std::function<bool(size_t, size_t)>;
+
+  // trend[i] is the trend at data point i, positive over all of them
+  bool Fit(const TimeSeries& data, const std::vector<double>& trend);
+
+  // from the last data point over the evenly spaced dates after it, with
+  // the trend at them; bands[j] are the settings.percentiles[j] percentiles
+  // of the paths at these dates, which the first of them starts from
+  bool Simulate(const std::vector<time_t>& dates,
+                const std::vector<double>& trend,
+                const SimulationSettings& settings, ThreadPool& pool,
+                std::vector<TimeSeries>& bands,
+                const ProgressCallback& report_progress = nullptr);
+
+  double GetVolatility() const;  // of the log deviation, per day
+  const std::string& GetError() const;
+
+ private:
+  static const size_t kChunkSize = 16 * 1024;  // paths per task, even
+
+  void AdvancePaths(const SimulationSettings& settings, size_t step,
+                    double step_days, double compensation, size_t first_path,
+                    size_t last_path, double* deviations) const;
+  static void SelectPercentiles(const std::vector<double>& percentiles,
+                                std::vector<double>& deviations,
+                                double* selected);
+
+  double start_deviation_ = 0.0;
+  double volatility_ = 0.0;
+  std::vector<double> shocks_;  // standardized to one day, zero mean
+  std::string error_message_;
+};
+
+#endif  // ALGORITHMIC_TRADING_MODEL_PRICESIMULATOR_H
@@ -0,0 +1,302 @@
+#include "recursive_least_squares.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "chebyshev.h"
+#include "lu_decomposition.h"
+
+namespace {
+
+// initial covariance of the coefficients, a vague prior that the first bars
+// outweigh at once
+const double kInitialCovariance = 1e8;
+
+}  // namespace
+
+RecursiveLeastSquares::RecursiveLeastSquares(int degree,
+                                             double forgetting_factor,
+                                             size_t window_size)
+    : degree_(std::max(degree, 0)),
+      forgetting_factor_(forgetting_factor),
+      window_size_(window_size > 0
+                       ? std::max<size_t>(window_size, degree_ + 1)
+                       : 0) {
+  Reset();
+}
+
+void RecursiveLeastSquares::Update(time_t date, double price) {
+  if (size_ == 0) {
+    first_date_ = date;
+    center_ = date;
+    scale_ = 1.0;
+  } else if (std::fabs(NormalizeDate(date)) > 1.0) {
+    Rebase(date);
+  }
+
+  AddSample(NormalizeDate(date), price);
+  ++size_;
+  weight_sum_ = forgetting_factor_ * weight_sum_ + 1.0;
+  weighted_offset_sum_ = forgetting_factor_ * weighted_offset_sum_ +
+                         static_cast<double>(date - first_date_);
+
+  if (window_size_ > 0) {
+    if (window_.size() < window_size_) {
+      window_.emplace_back(date, price);
+    } else {
+      auto [old_date, old_price] = window_[window_first_];
+      window_[window_first_] = {date, price};
+      window_first_ = (window_first_ + 1) % window_size_;
+      RemoveSample(NormalizeDate(old_date), old_price,
+                   std::pow(forgetting_factor_, window_size_));
+      --size_;
+    }
+
+    // removals lose accuracy much faster than additions, solving once per
+    // degree + 1 bars bounds that at O(degree^2) per bar
+    if (++updates_count_ > static_cast<size_t>(degree_)) {
+      Solve();
+    }
+  }
+}
+
+void RecursiveLeastSquares::Reset() {
+  size_t size = degree_ + 1;
+  coeffs_.assign(size, 0.0);
+  covariance_.Assign(size, size);
+  for (size_t i = 0; i < size; ++i) {
+    covariance_[i][i] = kInitialCovariance;
+  }
+  prior_weight_ = 1.0 / kInitialCovariance;
+  condition_number_ = 1.0;
+  gram_.Assign(size, size);
+  rhs_.assign(size, 0.0);
+  regressors_.assign(size, 0.0);
+  gain_.assign(size, 0.0);
+
+  size_ = 0;
+  updates_count_ = 0;
+  window_.clear();
+  window_.reserve(window_size_);
+  window_first_ = 0;
+  weight_sum_ = 0.0;
+  weighted_offset_sum_ = 0.0;
+}
+
+double RecursiveLeastSquares::ApproximatePrice(time_t date) const {
+  return SumChebyshevSeries(coeffs_, NormalizeDate(date));
+}
+
+size_t RecursiveLeastSquares::size() const { return size_; }
+
+double RecursiveLeastSquares::GetConditionNumber() const {
+  return condition_number_;
+}
+
+// decays the estimate by the forgetting factor and adds one bar,
+// P = (P - g * g^T / (lambda + phi^T * g)) / lambda with g = P * phi
+void RecursiveLeastSquares::AddSample(double x, double price) {
+  DefineRegressors(x);
+  const std::vector<double>& regressors = regressors_;
+  std::vector<double>& gain = gain_;
+  size_t size = regressors.size();
+
+  double denominator = forgetting_factor_;
+  double error = price;
+  for (size_t i = 0; i < size; ++i) {
+    gain[i] = 0.0;
+    for (size_t j = 0; j < size; ++j) {
+      gain[i] += covariance_[i][j] * regressors[j];
+    }
+    denominator += regressors[i] * gain[i];
+    error -= coeffs_[i] * regressors[i];
+  }
+
+  for (size_t i = 0; i < size; ++i) {
+    coeffs_[i] += gain[i] * error / denominator;
+    rhs_[i] = forgetting_factor_ * rhs_[i] + regressors[i] * price;
+    for (size_t j = 0; j < size; ++j) {
+      covariance_[i][j] =
+          (covariance_[i][j] - gain[i] * gain[j] / denominator) /
+          forgetting_factor_;
+      gram_[i][j] =
+          forgetting_factor_ * gram_[i][j] + regressors[i] * regressors[j];
+    }
+  }
+  prior_weight_ *= forgetting_factor_;
+}
+
+// removes a bar of the given weight, the inverse of AddSample without decay
+void RecursiveLeastSquares::RemoveSample(double x, double price,
+                                         double weight) {
+  DefineRegressors(x);
+  const std::vector<double>& regressors = regressors_;
+  std::vector<double>& gain = gain_;
+  size_t size = regressors.size();
+
+  double denominator = 1.0;
+  double error = price;
+  for (size_t i = 0; i < size; ++i) {
+    gain[i] = 0.0;
+    for (size_t j = 0; j < size; ++j) {
+      gain[i] += covariance_[i][j] * regressors[j];
+    }
+    denominator -= weight * regressors[i] * gain[i];
+    error -= coeffs_[i] * regressors[i];
+  }
+
+  for (size_t i = 0; i < size; ++i) {
+    coeffs_[i] -= weight * gain[i] * error / denominator;
+    rhs_[i] -= weight * regressors[i] * price;
+    for (size_t j = 0; j < size; ++j) {
+      covariance_[i][j] += weight * gain[i] * gain[j] / denominator;
+      gram_[i][j] -= weight * regressors[i] * regressors[j];
+    }
+  }
+}
+
+// moves the normalization so that the bars in the estimate take [-1, 1/3]
+// and the stream may run half as far again before the next rebase
+void RecursiveLeastSquares::Rebase(time_t date) {
+  ScratchArena::Scope scope;
+  double lower_date;
+  if (window_size_ > 0) {
+    lower_date = window_[window_first_].first;
+  } else {
+    // bars weigh evenly around their weighted mean date
+    double mean_date = first_date_ + weighted_offset_sum_ / weight_sum_;
+    lower_date = std::max<double>(first_date_, 2.0 * mean_date - date);
+  }
+
+  double scale = std::max(0.75 * (date - lower_date), 1.0);
+  double center = lower_date + scale;
+
+  size_t size = coeffs_.size();
+  if (window_size_ > 0) {
+    // the window is at hand, so its normal equations are summed afresh,
+    // which keeps the rounding errors of the removals from building up
+    center_ = center;
+    scale_ = scale;
+    gram_.Assign(size, size);
+    rhs_.assign(size, 0.0);
+    for (size_t k = 0; k < window_.size(); ++k) {
+      const auto& [window_date, window_price] =
+          window_[(window_first_ + k) % window_.size()];
+      DefineRegressors(NormalizeDate(window_date));
+      const std::vector<double>& regressors = regressors_;
+      for (size_t i = 0; i < size; ++i) {
+        rhs_[i] = forgetting_factor_ * rhs_[i] + regressors[i] * window_price;
+        for (size_t j = 0; j < size; ++j) {
+          gram_[i][j] = forgetting_factor_ * gram_[i][j] +
+                        regressors[i] * regressors[j];
+        }
+      }
+    }
+  } else {
+    // with the old regressors phi = T^T * phi_new the normal equations move
+    // to G_new = T^-T * G * T^-1 and h_new = T^-T * h, where T^-1 is the
+    // transform of the inverse map x_new = (x_old - beta) / alpha
+    double alpha = scale / scale_;
+    double beta = (center - center_) / scale_;
+    ScratchMatrix inverse_transform =
+        DefineBasisTransform(1.0 / alpha, -beta / alpha);
+    center_ = center;
+    scale_ = scale;
+
+    ScratchMatrix product(size, size);
+    ScratchVector<double> rhs(size, 0.0);
+    for (size_t i = 0; i < size; ++i) {
+      for (size_t k = 0; k < size; ++k) {
+        rhs[i] += inverse_transform[k][i] * rhs_[k];
+        for (size_t j = 0; j < size; ++j) {
+          product[i][j] += inverse_transform[k][i] * gram_[k][j];
+        }
+      }
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+      for (size_t j = 0; j < size; ++j) {
+        gram_[i][j] = 0.0;
+        for (size_t k = 0; k < size; ++k) {
+          gram_[i][j] += product[i][k] * inverse_transform[k][j];
+        }
+      }
+    }
+    rhs_.assign(rhs.begin(), rhs.end());
+  }
+
+  Solve();
+}
+
+// solves the normal equations afresh, which clears the rounding errors the
+// updates have left in the covariance; the prior is added in the current
+// basis, as carried over from an older one it would be stretched along with
+// the time axis
+void RecursiveLeastSquares::Solve() {
+  ScratchArena::Scope scope;
+  size_t size = coeffs_.size();
+  ScratchMatrix gram(gram_);
+  for (size_t i = 0; i < size; ++i) {
+    gram[i][i] += prior_weight_;
+  }
+
+  // the inverse by columns, solving for the columns of the identity
+  LuDecomposition lu(gram);
+  ScratchVector<double> column(size);
+  for (size_t j = 0; j < size; ++j) {
+    column.assign(size, 0.0);
+    column[j] = 1.0;
+    lu.Solve(column.data());
+    for (size_t i = 0; i < size; ++i) {
+      covariance_[i][j] = column[i];
+    }
+  }
+  condition_number_ = lu.GetConditionNumber();
+  for (size_t i = 0; i < size; ++i) {
+    coeffs_[i] = 0.0;
+    for (size_t j = 0; j < size; ++j) {
+      coeffs_[i] += covariance_[i][j] * rhs_[j];
+    }
+  }
+  updates_count_ = 0;
+}
+
+void RecursiveLeastSquares::DefineRegressors(double x) {
+  DefineChebyshevValues(x, regressors_);
+}
+
+// column k holds T(k)(alpha * x + beta) in Chebyshev polynomials of x, so the
+// matrix turns coefficients over alpha * x + beta into coefficients over x;
+// built by the same recurrence with x * T(j) = (T(j+1) + T(|j-1|)) / 2
+ScratchMatrix RecursiveLeastSquares::DefineBasisTransform(double alpha,
+                                                         double beta) const {
+  size_t size = degree_ + 1;
+  ScratchMatrix transform(size, size);
+  transform[0][0] = 1.0;
+  if (size > 1) {
+    transform[0][1] = beta;
+    transform[1][1] = alpha;
+  }
+
+  for (size_t k = 1; k + 1 < size; ++k) {
+    for (size_t j = 0; j <= k + 1; ++j) {
+      transform[j][k + 1] = -transform[j][k - 1];
+    }
+    for (size_t j = 0; j <= k; ++j) {
+      double value = transform[j][k];
+      transform[j][k + 1] += 2.0 * beta * value;
+      if (j == 0) {
+        transform[1][k + 1] += 2.0 * alpha * value;
+      } else {
+        transform[j + 1][k + 1] += alpha * value;
+        transform[j - 1][k + 1] += alpha * value;
+      }
+    }
+  }
+
+  return transform;
+}
+
+double RecursiveLeastSquares::NormalizeDate(time_t date) const {
+  return (date - center_) / scale_;
+}
@@ -0,0 +1,73 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_RECURSIVELEASTSQUARES_H
+#define ALGORITHMIC_TRADING_MODEL_RECURSIVELEASTSQUARES_H
+
+#include <ctime>
+#include <utility>
+#include <vector>
+
+#include "matrix.h"
+
+// Least squares polynomial over a stream of prices, refreshed on every new
+// bar by recursive least squares in O(degree^2). Older bars can be discounted
+// by a forgetting factor and dropped once they leave a sliding window.
+// The polynomial is kept in Chebyshev polynomials of the time normalized to
+// [-1, 1], which stay well conditioned up to high degrees; when a bar falls
+// outside it the normalization is moved over the bars in the estimate and
+// the estimate is carried over to the new basis.
+class RecursiveLeastSquares {
+ public:
+  // forgetting_factor in (0, 1], where 1 weighs all bars equally;
+  // window_size 0 keeps every bar, otherwise it is at least degree + 1
+  explicit RecursiveLeastSquares(int degree, double forgetting_factor = 1.0,
+                                 size_t window_size = 0);
+
+  // dates must be ascending
+  void Update(time_t date, double price);
+  void Reset();
+
+  double ApproximatePrice(time_t date) const;
+  size_t size() const;  // bars in the estimate
+  // of the normal equations, prior included, at their last full solve; the
+  // recursive updates in between do not estimate it
+  double GetConditionNumber() const;
+
+ private:
+  void AddSample(double x, double price);
+  void RemoveSample(double x, double price, double weight);
+  void Rebase(time_t date);
+  void Solve();
+  void DefineRegressors(double x);
+  ScratchMatrix DefineBasisTransform(double alpha, double beta) const;
+  double NormalizeDate(time_t date) const;
+
+  int degree_;
+  double forgetting_factor_;
+  size_t window_size_;
+
+  double center_ = 0.0;
+  double scale_ = 1.0;
+  std::vector<double> coeffs_;  // of the Chebyshev polynomials T0, T1, ...
+  Matrix covariance_;           // inverse of the weighted Gram matrix
+  double prior_weight_ = 0.0;   // of the initial covariance in the Gram matrix
+  double condition_number_ = 1.0;
+
+  // normal equations of the bars alone, kept to move to a new basis exactly
+  Matrix gram_;
+  std::vector<double> rhs_;
+
+  // of the bar being added or removed, kept to spare the allocations
+  std::vector<double> regressors_;
+  std::vector<double> gain_;
+
+  size_t size_ = 0;
+  size_t updates_count_ = 0;  // since the last Solve
+  // ring buffer of the bars in the window, the oldest at window_first_
+  std::vector<std::pair<time_t, double>> window_;
+  size_t window_first_ = 0;
+  // weighted mean date of the estimate, to place the normalization
+  time_t first_date_ = 0;
+  double weight_sum_ = 0.0;
+  double weighted_offset_sum_ = 0.0;
+};
+
+#endif  // ALGORITHMIC_TRADING_MODEL_RECURSIVELEASTSQUARES_H
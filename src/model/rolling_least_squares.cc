@@ -0,0 +1,183 @@
+#include "rolling_least_squares.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "chebyshev.h"
+#include "condition_number.h"
+#include "lu_decomposition.h"
+
+RollingLeastSquares::RollingLeastSquares(const TimeSeries& data, int degree,
+                                         size_t first_idx)
+    : data_(data),
+      degree_(std::max(degree, 0)),
+      first_idx_(first_idx),
+      last_idx_(first_idx),
+      moments_(2 * degree_ + 1),
+      rhs_(degree_ + 1),
+      values_(2 * degree_ + 1) {}
+
+void RollingLeastSquares::PushBack() {
+  ++last_idx_;
+  is_changed_ = true;
+
+  if (last_idx_ - first_idx_ == 1 ||
+      std::fabs(NormalizeDate(data_.Dates()[last_idx_ - 1])) > 1.0) {
+    Rebase();
+  } else {
+    AddSums(last_idx_ - 1, 1.0);
+  }
+}
+
+void RollingLeastSquares::PopFront() {
+  AddSums(first_idx_, -1.0);
+  ++first_idx_;
+  is_changed_ = true;
+}
+
+double RollingLeastSquares::ApproximatePrice(time_t date) {
+  if (is_changed_) {
+    DefineApproximationCoefficients();
+    is_changed_ = false;
+  }
+
+  return SumChebyshevSeries(coeffs_, NormalizeDate(date));
+}
+
+// one Cholesky factorization G = L * L^T of the full Gram matrix, whose
+// leading blocks factor the Gram matrices of the lower degrees; the forward
+// substitution is shared too, so a degree only adds its back substitution
+size_t RollingLeastSquares::FitDegrees(Matrix& fits) const {
+  ScratchArena::Scope scope;
+  size_t bars_count = last_idx_ - first_idx_;
+  size_t size = std::min<size_t>(degree_ + 1, bars_count);
+  ScratchMatrix lower = DefineChebyshevGramMatrix(moments_.data(), size);
+  ScratchVector<double> forward(size);
+
+  // x = (L_k * L_k^T)^-1 * x over the leading block of the degree k, for
+  // the condition number of its normal equations
+  auto solve = [&lower](size_t k, double* x) {
+    for (size_t i = 0; i <= k; ++i) {
+      for (size_t m = 0; m < i; ++m) {
+        x[i] -= lower[i][m] * x[m];
+      }
+      x[i] /= lower[i][i];
+    }
+    for (size_t i = k + 1; i-- > 0;) {
+      for (size_t j = i + 1; j <= k; ++j) {
+        x[i] -= lower[j][i] * x[j];
+      }
+      x[i] /= lower[i][i];
+    }
+  };
+
+  // a pivot lost to rounding, or normal equations too ill-conditioned to
+  // trust, end the degrees that can be fitted; the upper triangle keeps G
+  // for the 1-norms of the leading blocks
+  ScratchVector<double> column_norms(size, 0.0);
+  double norm = 0.0;
+  size_t fitted_count = 0;
+  for (; fitted_count < size; ++fitted_count) {
+    size_t k = fitted_count;
+    for (size_t j = 0; j < k; ++j) {
+      column_norms[j] += std::fabs(lower[j][k]);
+      column_norms[k] += std::fabs(lower[j][k]);
+      norm = std::max(norm, column_norms[j]);
+    }
+    column_norms[k] += std::fabs(lower[k][k]);
+    norm = std::max(norm, column_norms[k]);
+
+    for (size_t j = 0; j <= k; ++j) {
+      double value = lower[k][j];
+      for (size_t m = 0; m < j; ++m) {
+        value -= lower[k][m] * lower[j][m];
+      }
+      lower[k][j] = j < k ? value / lower[j][j] : value;
+    }
+    if (!(lower[k][k] > DefinePivotTolerance(k + 1, norm))) {
+      break;
+    }
+    lower[k][k] = std::sqrt(lower[k][k]);
+
+    // symmetric, so the transposed solve is the same
+    auto solve_block = [&solve, k](double* x) { solve(k, x); };
+    double condition_number =
+        norm * EstimateInverseNorm(k + 1, solve_block, solve_block);
+    if (!(condition_number <= kMaxConditionNumber)) {
+      break;
+    }
+
+    double value = rhs_[k];
+    for (size_t m = 0; m < k; ++m) {
+      value -= lower[k][m] * forward[m];
+    }
+    forward[k] = value / lower[k][k];
+  }
+
+  fits.Assign(degree_ + 1, degree_ + 1);
+  for (size_t degree = 0; degree < fitted_count; ++degree) {
+    double* coeffs = fits[degree];
+    for (size_t i = degree + 1; i-- > 0;) {
+      double value = forward[i];
+      for (size_t j = i + 1; j <= degree; ++j) {
+        value -= lower[j][i] * coeffs[j];
+      }
+      coeffs[i] = value / lower[i][i];
+    }
+  }
+
+  return fitted_count;
+}
+
+double RollingLeastSquares::ApproximatePrice(const Matrix& fits, int degree,
+                                             time_t date) const {
+  return SumChebyshevSeries(fits[degree], degree + 1, NormalizeDate(date));
+}
+
+double RollingLeastSquares::GetConditionNumber() const {
+  return condition_number_;
+}
+
+void RollingLeastSquares::AddSums(size_t idx, double sign) {
+  DefineChebyshevValues(NormalizeDate(data_.Dates()[idx]), values_);
+  double price = sign * data_.Prices()[idx];
+  for (size_t k = 0; k < moments_.size(); ++k) {
+    moments_[k] += sign * values_[k];
+  }
+  for (size_t k = 0; k < rhs_.size(); ++k) {
+    rhs_[k] += values_[k] * price;
+  }
+}
+
+// normalizes the window to [-1, 1/3], so it slides on for a third of its
+// length before the next rebase
+void RollingLeastSquares::Rebase() {
+  double lower_date = data_.Dates()[first_idx_];
+  double upper_date = data_.Dates()[last_idx_ - 1];
+  scale_ = std::max(0.75 * (upper_date - lower_date), 1.0);
+  center_ = lower_date + scale_;
+
+  std::fill(moments_.begin(), moments_.end(), 0.0);
+  std::fill(rhs_.begin(), rhs_.end(), 0.0);
+  for (size_t i = first_idx_; i < last_idx_; ++i) {
+    AddSums(i, 1.0);
+  }
+}
+
+// normal equations of the Chebyshev basis
+void RollingLeastSquares::DefineApproximationCoefficients() {
+  ScratchArena::Scope scope;
+  // a polynomial of degree k is only defined by more than k distinct points
+  size_t bars_count = std::max<size_t>(last_idx_ - first_idx_, 1);
+  size_t size = std::min<size_t>(degree_ + 1, bars_count);
+
+  ScratchMatrix gram = DefineChebyshevGramMatrix(moments_.data(), size);
+  LuDecomposition lu(gram);
+  coeffs_.assign(rhs_.begin(), rhs_.begin() + size);
+  lu.Solve(coeffs_.data());
+  condition_number_ = lu.GetConditionNumber();
+}
+
+double RollingLeastSquares::NormalizeDate(time_t date) const {
+  return (date - center_) / scale_;
+}
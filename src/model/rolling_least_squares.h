@@ -0,0 +1,63 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_ROLLINGLEASTSQUARES_H
+#define ALGORITHMIC_TRADING_MODEL_ROLLINGLEASTSQUARES_H
+
+#include <vector>
+
+#include "matrix.h"
+#include "time_series.h"
+
+// Least squares polynomial over a window sliding along a series. Bars enter
+// and leave the window through sums of Chebyshev polynomials of the
+// normalized time, O(degree) each, and the normal equations are made of
+// these sums, so a fit costs O(degree^3) whatever the window length. When a
+// new bar falls outside [-1, 1] the normalization is moved over the window
+// and the sums are recomputed exactly, which also drops their rounding
+// errors.
+class RollingLeastSquares {
+ public:
+  // the series must outlive the polynomial; the window starts empty at the
+  // first_idx bar
+  RollingLeastSquares(const TimeSeries& data, int degree,
+                      size_t first_idx = 0);
+
+  void PushBack();  // takes the next bar of the series into the window
+  void PopFront();  // drops the oldest bar of the window
+
+  double ApproximatePrice(time_t date);
+
+  // fits of every degree up to the polynomial's over the window at once, as
+  // the normal equations of a lower degree are the leading block of the full
+  // ones; row k of fits holds the coefficients of degree k, and the count of
+  // the leading degrees that are well defined and conditioned within
+  // kMaxConditionNumber is returned
+  size_t FitDegrees(Matrix& fits) const;
+  // evaluates the fit of FitDegrees of the given degree, valid until the
+  // window changes
+  double ApproximatePrice(const Matrix& fits, int degree, time_t date) const;
+
+  // of the normal equations of the last fit of ApproximatePrice, estimated
+  // in the 1-norm; the fit loses about log10 of it of its 16 digits
+  double GetConditionNumber() const;
+
+ private:
+  void AddSums(size_t idx, double sign);
+  void Rebase();
+  void DefineApproximationCoefficients();
+  double NormalizeDate(time_t date) const;
+
+  const TimeSeries& data_;
+  int degree_;
+  size_t first_idx_;
+  size_t last_idx_;  // past the window
+
+  double center_ = 0.0;
+  double scale_ = 1.0;
+  std::vector<double> moments_;  // sums of T(k)(x), k <= 2 * degree
+  std::vector<double> rhs_;      // sums of T(k)(x) * price, k <= degree
+  std::vector<double> values_;   // T(k)(x) of a single bar
+  std::vector<double> coeffs_;   // of T(k), valid unless is_changed_
+  double condition_number_ = 1.0;
+  bool is_changed_ = true;
+};
+
+#endif  // ALGORITHMIC_TRADING_MODEL_ROLLINGLEASTSQUARES_H
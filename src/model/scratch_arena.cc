@@ -0,0 +1,59 @@
+#include "scratch_arena.h"
+
+#include <algorithm>
+#include <cassert>
+
+ScratchArena::Scope::Scope()
+    : arena_(Local()),
+      block_idx_(arena_.block_idx_),
+      offset_(arena_.offset_) {
+  ++arena_.scopes_count_;
+}
+
+ScratchArena::Scope::~Scope() {
+  arena_.block_idx_ = block_idx_;
+  arena_.offset_ = offset_;
+  if (--arena_.scopes_count_ > 0) {
+    return;
+  }
+
+  // the blocks double in size, so the last ones are the largest
+  size_t total_size = 0;
+  for (const Block& block : arena_.blocks_) {
+    total_size += block.size;
+  }
+  while (arena_.blocks_.size() > 1 && total_size > kRetainedSize) {
+    total_size -= arena_.blocks_.back().size;
+    arena_.blocks_.pop_back();
+  }
+  arena_.block_idx_ = 0;
+  arena_.offset_ = 0;
+}
+
+ScratchArena& ScratchArena::Local() {
+  thread_local ScratchArena arena;
+  return arena;
+}
+
+void* ScratchArena::Allocate(size_t size, size_t alignment) {
+  assert(scopes_count_ > 0 && "scratch memory outside of a Scope");
+
+  // blocks come from new[], aligned for any fundamental type
+  for (; block_idx_ < blocks_.size(); ++block_idx_, offset_ = 0) {
+    Block& block = blocks_[block_idx_];
+    size_t offset = (offset_ + alignment - 1) / alignment * alignment;
+    if (offset + size <= block.size) {
+      offset_ = offset + size;
+      return block.data.get() + offset;
+    }
+  }
+
+  size_t block_size = std::max(
+      size, blocks_.empty() ? kFirstBlockSize : 2 * blocks_.back().size);
+  blocks_.push_back(
+      Block{std::unique_ptr<std::byte[]>(new std::byte[block_size]),
+            block_size});
+  block_idx_ = blocks_.size() - 1;
+  offset_ = size;
+  return blocks_.back().data.get();
+}
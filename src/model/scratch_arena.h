@@ -0,0 +1,79 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_SCRATCHARENA_H
+#define ALGORITHMIC_TRADING_MODEL_SCRATCHARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Per-thread bump allocator for the temporaries of the fits. Memory is
+// handed out from blocks the arena keeps, and a Scope gives back everything
+// allocated since it was opened when it closes, so repeated fits reuse the
+// same blocks and stop allocating once the largest of them has been seen.
+// The blocks beyond kRetainedSize are freed when the outermost Scope
+// closes, so one huge fit does not pin its memory to the thread for good.
+class ScratchArena {
+ public:
+  // scratch containers may only live inside a Scope opened before them
+  class Scope {
+   public:
+    Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope();
+
+   private:
+    ScratchArena& arena_;
+    size_t block_idx_;
+    size_t offset_;
+  };
+
+  static const size_t kFirstBlockSize = 64 * 1024;
+  static const size_t kRetainedSize = 8 * 1024 * 1024;
+
+  static ScratchArena& Local();  // the arena of the calling thread
+
+  void* Allocate(size_t size, size_t alignment);
+
+ private:
+  struct Block {
+    std::unique_ptr<std::byte[]> data;
+    size_t size;
+  };
+
+  std::vector<Block> blocks_;
+  size_t block_idx_ = 0;  // current block, blocks_.size() when none
+  size_t offset_ = 0;     // used bytes of the current block
+  int scopes_count_ = 0;
+};
+
+// std::allocator replacement drawing from the arena of the calling thread;
+// deallocation is left to the enclosing ScratchArena::Scope
+template <typename T>
+class ScratchAllocator {
+ public:
+  using value_type = T;
+
+  ScratchAllocator() = default;
+  template <typename U>
+  ScratchAllocator(const ScratchAllocator<U>&) {}
+
+  T* allocate(size_t count) {
+    return static_cast<T*>(
+        ScratchArena::Local().Allocate(count * sizeof(T), alignof(T)));
+  }
+  void deallocate(T*, size_t) {}
+
+  template <typename U>
+  bool operator==(const ScratchAllocator<U>&) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const ScratchAllocator<U>&) const {
+    return false;
+  }
+};
+
+template <typename T>
+using ScratchVector = std::vector<T, ScratchAllocator<T>>;
+
+#endif  // ALGORITHMIC_TRADING_MODEL_SCRATCHARENA_H
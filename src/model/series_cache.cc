@@ -0,0 +1,248 @@
+#include "series_cache.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#else
+#include <fstream>
+#include <random>
+#endif
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+#include "mapped_file.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char kMagic[4] = {'A', 'T', 'S', 'C'};
+const uint32_t kVersion = 1;
+
+struct Header {
+  char magic[4];
+  uint32_t version;
+  uint64_t count;
+  int64_t first_date;
+  uint64_t source_size;
+  int64_t source_time;
+  uint64_t checksum;
+};
+
+static_assert(sizeof(Header) % sizeof(double) == 0,
+              "the prices must stay aligned in the mapped file");
+
+// 64-bit words mixed by a multiply and a shift, several times faster than
+// hashing byte by byte and enough to catch a damaged or truncated file
+uint64_t DefineChecksum(const char* data, size_t size) {
+  uint64_t hash = 0x9e3779b97f4a7c15ULL ^ size;
+  auto mix = [&hash](uint64_t word) {
+    hash = (hash ^ word) * 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 32;
+  };
+
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    mix(word);
+  }
+  uint64_t word = 0;
+  std::memcpy(&word, data + i, size - i);
+  mix(word);
+
+  return hash;
+}
+
+void WriteVarint(uint64_t value, std::string& buffer) {
+  while (value >= 0x80) {
+    buffer.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  buffer.push_back(static_cast<char>(value));
+}
+
+// a file of its own next to path, named so that no other process or thread
+// saving the same cache picks it too; empty when the file could not be
+// written, and then nothing is left behind
+std::string WriteTempFile(const std::string& path, const Header& header,
+                          const std::string& payload) {
+#if defined(__unix__) || defined(__APPLE__)
+  std::string temp_path = path + ".XXXXXX";
+  int fd = mkstemp(temp_path.data());
+  if (fd < 0) {
+    return std::string();
+  }
+  // mkstemp makes it private, the cache is shared like the CSV next to it
+  fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+  auto write_all = [fd](const char* data, size_t size) {
+    while (size > 0) {
+      ssize_t written = write(fd, data, size);
+      if (written <= 0) {
+        return false;
+      }
+      data += written;
+      size -= written;
+    }
+    return true;
+  };
+  bool is_written =
+      write_all(reinterpret_cast<const char*>(&header), sizeof(header)) &&
+      write_all(payload.data(), payload.size());
+  is_written = close(fd) == 0 && is_written;
+#else
+  std::random_device random;
+  std::string temp_path =
+      path + "." + std::to_string(random()) + std::to_string(random());
+  bool is_written = false;
+  {
+    std::ofstream ofs(temp_path, std::ios::binary);
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ofs.write(payload.data(), payload.size());
+    ofs.close();
+    is_written = !ofs.fail();
+  }
+#endif
+
+  if (!is_written) {
+    std::error_code error;
+    fs::remove(temp_path, error);
+    return std::string();
+  }
+
+  return temp_path;
+}
+
+bool ReadVarint(const char*& cursor, const char* end, uint64_t& value) {
+  value = 0;
+  for (int shift = 0; cursor != end && shift < 64; shift += 7) {
+    uint8_t byte = static_cast<uint8_t>(*cursor++);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (byte < 0x80) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+}  // namespace
+
+SeriesCache::SeriesCache(const std::string& csv_path)
+    : path_(csv_path + ".cache") {
+  std::error_code error;
+  source_size_ = fs::file_size(csv_path, error);
+  if (error) {
+    return;
+  }
+
+  fs::file_time_type time = fs::last_write_time(csv_path, error);
+  if (error) {
+    return;
+  }
+
+  source_time_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     time.time_since_epoch())
+                     .count();
+  has_source_ = true;
+}
+
+bool SeriesCache::Load(TimeSeries& data) const {
+  if (!has_source_) {
+    return false;
+  }
+
+  MappedFile file(path_);
+  if (!file.IsOpen() || file.Size() < sizeof(Header)) {
+    return false;
+  }
+
+  Header header;
+  std::memcpy(&header, file.Data(), sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion || header.source_size != source_size_ ||
+      header.source_time != source_time_) {
+    return false;
+  }
+
+  const char* payload = file.Data() + sizeof(header);
+  const char* end = file.Data() + file.Size();
+  if (header.count > (end - payload) / sizeof(double) ||
+      DefineChecksum(payload, end - payload) != header.checksum) {
+    return false;
+  }
+
+  TimeSeries series;
+  series.Reserve(header.count);
+  const char* prices = payload;
+  const char* cursor = payload + header.count * sizeof(double);
+  time_t date = header.first_date;
+  for (uint64_t i = 0; i < header.count; ++i) {
+    if (i > 0) {
+      uint64_t gap;
+      if (!ReadVarint(cursor, end, gap) || gap == 0) {
+        return false;
+      }
+      date += gap;
+    }
+
+    double price;
+    std::memcpy(&price, prices + i * sizeof(double), sizeof(price));
+    series.Append(date, price);
+  }
+
+  if (cursor != end) {
+    return false;
+  }
+
+  data = std::move(series);
+  return true;
+}
+
+bool SeriesCache::Save(const TimeSeries& data) const {
+  if (!has_source_) {
+    return false;
+  }
+
+  // daily gaps take 3 bytes and minute gaps 1
+  std::string payload(data.size() * sizeof(double), '\0');
+  if (!data.empty()) {
+    std::memcpy(payload.data(), data.Prices().data(), payload.size());
+  }
+  payload.reserve(payload.size() + 3 * data.size());
+  for (size_t i = 1; i < data.size(); ++i) {
+    WriteVarint(data.Dates()[i] - data.Dates()[i - 1], payload);
+  }
+
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.count = data.size();
+  header.first_date = data.empty() ? 0 : data.Dates().front();
+  header.source_size = source_size_;
+  header.source_time = source_time_;
+  header.checksum = DefineChecksum(payload.data(), payload.size());
+
+  std::string temp_path = WriteTempFile(path_, header, payload);
+  if (temp_path.empty()) {
+    return false;
+  }
+
+  std::error_code error;
+  fs::rename(temp_path, path_, error);
+  if (error) {
+    fs::remove(temp_path, error);
+    return false;
+  }
+
+  return true;
+}
+
+const std::string& SeriesCache::GetPath() const { return path_; }
+
+uint64_t SeriesCache::GetSourceSize() const { return source_size_; }
@@ -0,0 +1,41 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_SERIESCACHE_H
+#define ALGORITHMIC_TRADING_MODEL_SERIESCACHE_H
+
+#include <cstdint>
+#include <string>
+
+#include "time_series.h"
+
+// Binary copy of a parsed CSV kept next to it as <file>.cache, which is
+// memory-mapped and read back in one pass instead of parsing the text.
+// Layout, in native byte order:
+//   header    "ATSC", uint32 version, uint64 count, int64 first date,
+//             uint64 CSV size, int64 CSV modification time,
+//             uint64 checksum of everything after the header
+//   prices    double[count]
+//   dates     count - 1 LEB128 varints of the gaps between dates
+// The cache stands only while the CSV keeps the size and the modification
+// time it was written for; anything else, including a bad checksum, makes
+// Load fail so that the CSV is parsed again.
+class SeriesCache {
+ public:
+  // looks up the size and modification time of the CSV once, so that a
+  // cache saved after parsing it describes the file as it was parsed
+  explicit SeriesCache(const std::string& csv_path);
+
+  bool Load(TimeSeries& data) const;
+  // writes a temporary file renamed over the cache, so concurrent loads of
+  // the same CSV never read a partial one
+  bool Save(const TimeSeries& data) const;
+
+  const std::string& GetPath() const;
+  uint64_t GetSourceSize() const;
+
+ private:
+  std::string path_;
+  bool has_source_ = false;
+  uint64_t source_size_ = 0;
+  int64_t source_time_ = 0;
+};
+
+#endif  // ALGORITHMIC_TRADING_MODEL_SERIESCACHE_H
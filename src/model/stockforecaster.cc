@@ -1,57 +1,94 @@
 #include "stockforecaster.h"
 
+#include <algorithm>
+#include <charconv>
 #include <chrono>
-#include <cmath>
-#include <fstream>
-#include <iomanip>
-#include <iostream>
-#include <sstream>
+#include <cstdio>
+#include <cstring>
+
+#include "condition_number.h"
+#include "mapped_file.h"
+#include "rolling_least_squares.h"
+#include "series_cache.h"
+
+namespace {
+
+// false with the error for a fit left with too few digits to trust, see
+// kMaxConditionNumber; where follows the number, as the date of a window
+bool CheckConditionNumber(double condition_number, const std::string& where,
+                          const std::string& advice,
+                          std::string& error_message) {
+  if (condition_number <= kMaxConditionNumber) {
+    return true;
+  }
+
+  char condition[32];
+  std::snprintf(condition, sizeof(condition), "%.1e", condition_number);
+  error_message = "Least squares system is ill-conditioned (condition number " +
+                  std::string(condition) + where + "), " + advice;
+  return false;
+}
+
+}  // namespace
 
 bool StockForecaster::LoadData(const std::string& file_path) {
-  bool success = true;
-  std::vector<DataPoint> data;
+  auto start_time = std::chrono::steady_clock::now();
 
-  std::ifstream ifs(file_path);
-  if (!ifs.is_open()) {
-    error_message_ = "Unable to open file: " + file_path;
-    success = false;
+  // the cache looks the CSV up before it is parsed, see SeriesCache
+  SeriesCache cache(file_path);
+  TimeSeries data;
+  size_t file_size = 0;
+  bool success = is_data_cache_enabled_ && cache.Load(data);
+  if (success) {
+    file_size = cache.GetSourceSize();
   } else {
-    std::string line;
-    std::getline(ifs, line);
-
-    while (std::getline(ifs, line)) {
-      std::istringstream sstream(line);
+    success = ParseCsv(file_path, data, file_size);
+    if (success && is_data_cache_enabled_) {
+      cache.Save(data);  // a read-only directory just goes without a cache
+    }
+  }
 
-      std::string date;
-      std::getline(sstream, date, ',');
-      TimePoint time_point(date);
+  if (success) {
+    data_ = std::move(data);
+    ++data_version_;
+    FitTrackedTrend();
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start_time;
+    load_throughput_ =
+        elapsed.count() > 0.0 ? file_size / 1e6 / elapsed.count() : 0.0;
+  }
 
-      double price;
-      sstream >> price;
+  return success;
+}
 
-      if (sstream.fail() || !time_point.isValid()) {
-        error_message_ = "File has invalid data: " + line;
-        success = false;
-        break;
-      }
+bool StockForecaster::Append(const DataPoint& data_point) {
+  if (!data_point.date.isValid()) {
+    error_message_ = "Invalid date of the new data";
+    return false;
+  }
 
-      if (!data.empty() && time_point.Value() <= data.back().date.Value()) {
-        error_message_ = "File data must be sorted in ascending order: " + line;
-        success = false;
-        break;
-      }
+  time_t date = data_point.date.ToTime_t();
+  if (!data_.empty() && date <= data_.Dates().back()) {
+    error_message_ = "New data must be later than the loaded data: " +
+                     data_point.date.ToString();
+    return false;
+  }
 
-      data.emplace_back(time_point, price);
-    }
+  bool is_spline_fitted = spline_version_ == data_version_;
+  data_.Append(date, data_point.price);
+  ++data_version_;
 
-    ifs.close();
+  if (is_spline_fitted) {
+    spline_.Append(date, data_point.price);
+    spline_version_ = data_version_;
   }
 
-  if (success) {
-    data_ = data;
+  if (trend_) {
+    trend_->Update(date, data_point.price);
   }
 
-  return success;
+  return true;
 }
 
 bool StockForecaster::InterpolatePriceByCubicSplineMethod(time_t date) {
@@ -60,10 +97,10 @@ bool StockForecaster::InterpolatePriceByCubicSplineMethod(time_t date) {
     return false;
   }
 
-  std::array<std::vector<double>, 4> coeffs = DefineInterpolationCoefficients();
-  int pivot_date_idx = DefinePivotDateIndex(date);
+  const CubicSpline& spline = GetFittedSpline();
+  size_t pivot_date_idx = DefinePivotDateIndex(date);
 
-  forecast_price_ = InterpolatePrice(date, coeffs, pivot_date_idx);
+  forecast_price_ = spline.InterpolatePrice(date, pivot_date_idx);
 
   return true;
 }
@@ -74,17 +111,74 @@ bool StockForecaster::InterpolatePricesByCubicSplineMethod(int dates_count) {
     return false;
   }
 
-  time_t period = data_.back().date.ToTime_t() - data_.front().date.ToTime_t();
+  time_t period = data_.Dates().back() - data_.Dates().front();
   std::vector<time_t> dates = DefineDates(dates_count, period);
 
-  std::array<std::vector<double>, 4> coeffs = DefineInterpolationCoefficients();
+  const CubicSpline& spline = GetFittedSpline();
 
-  forecast_ = std::vector<DataPoint>();
-  forecast_.reserve(dates.size());
+  // evaluated in batches between the progress reports
+  std::vector<size_t> pivot_date_idxs(dates.size());
+  std::vector<double> prices(dates.size());
+  size_t pivot_date_idx = 0;
+  size_t progress_step = std::max<size_t>(dates.size() / 100, 1);
+  for (size_t first = 0; first < dates.size(); first += progress_step) {
+    if (!ReportProgress(first, dates.size(), error_message_)) {
+      forecast_.Clear();
+      return false;
+    }
+
+    size_t last = std::min(first + progress_step, dates.size());
+    for (size_t i = first; i < last; ++i) {
+      pivot_date_idx = DefinePivotDateIndex(dates[i], pivot_date_idx);
+      pivot_date_idxs[i] = pivot_date_idx;
+    }
+    spline.InterpolatePrices(dates.data() + first,
+                             pivot_date_idxs.data() + first, last - first,
+                             prices.data() + first);
+  }
+
+  forecast_.Clear();
+  forecast_.Reserve(dates.size());
   for (size_t i = 0; i < dates.size(); ++i) {
-    int pivot_date_idx = DefinePivotDateIndex(dates[i]);
-    double price = InterpolatePrice(dates[i], coeffs, pivot_date_idx);
-    forecast_.emplace_back(dates[i], price);
+    forecast_.Append(dates[i], prices[i]);
+  }
+
+  return true;
+}
+
+bool StockForecaster::InterpolateRollingPricesByCubicSplineMethod(
+    int window_size, int horizon) {
+  return InterpolateRollingPricesByCubicSplineMethod(window_size, horizon,
+                                                     forecast_, error_message_);
+}
+
+bool StockForecaster::InterpolateRollingPricesByCubicSplineMethod(
+    int window_size, int horizon, TimeSeries& forecast,
+    std::string& error_message) const {
+  if (!CheckRollingWindow(window_size, horizon, error_message)) {
+    return false;
+  }
+
+  // only the last knots of a window shape its last segment
+  size_t knots_count =
+      std::min<size_t>(window_size, CubicSpline::kTailSize + 1);
+  size_t first_idx = window_size - 1;
+  size_t total_count = data_.size() - horizon - first_idx;
+
+  forecast.Clear();
+  forecast.Reserve(total_count);
+  size_t progress_step = std::max<size_t>(total_count / 100, 1);
+  CubicSpline spline;  // refitted in place for every window
+  for (size_t i = first_idx; i + horizon < data_.size(); ++i) {
+    if ((i - first_idx) % progress_step == 0 &&
+        !ReportProgress(i - first_idx, total_count, error_message)) {
+      forecast.Clear();
+      return false;
+    }
+
+    spline.Fit(data_, i + 1 - knots_count, i + 1);
+    time_t date = data_.Dates()[i + horizon];
+    forecast.Append(date, spline.InterpolatePrice(date, knots_count - 1));
   }
 
   return true;
@@ -97,8 +191,12 @@ bool StockForecaster::ApproximatePriceByLeastSquaresMethod(time_t date,
     return false;
   }
 
-  std::vector<double> coeffs = DefineApproximationCoefficients(degree);
-  forecast_price_ = ApproximatePrice(date, coeffs);
+  const LeastSquaresPolynomial* polynomial = GetCheckedPolynomial(degree);
+  if (!polynomial) {
+    return false;
+  }
+
+  forecast_price_ = polynomial->ApproximatePrice(date);
 
   return true;
 }
@@ -115,197 +213,408 @@ bool StockForecaster::ApproximatePricesByLeastSquaresMethod(int dates_count,
       data_.back().date.AddDays(future_days) - data_.front().date.ToTime_t();
   std::vector<time_t> dates = DefineDates(dates_count, period);
 
-  std::vector<double> coeffs = DefineApproximationCoefficients(degree);
+  const LeastSquaresPolynomial* polynomial = GetCheckedPolynomial(degree);
+  if (!polynomial) {
+    return false;
+  }
+
+  // evaluated in batches between the progress reports
+  std::vector<double> prices(dates.size());
+  size_t progress_step = std::max<size_t>(dates.size() / 100, 1);
+  for (size_t first = 0; first < dates.size(); first += progress_step) {
+    if (!ReportProgress(first, dates.size(), error_message_)) {
+      forecast_.Clear();
+      return false;
+    }
 
-  forecast_ = std::vector<DataPoint>();
-  forecast_.reserve(dates.size());
+    size_t last = std::min(first + progress_step, dates.size());
+    polynomial->ApproximatePrices(dates.data() + first, last - first,
+                                  prices.data() + first);
+  }
+
+  forecast_.Clear();
+  forecast_.Reserve(dates.size());
   for (size_t i = 0; i < dates.size(); ++i) {
-    double price = ApproximatePrice(dates[i], coeffs);
-    forecast_.emplace_back(dates[i], price);
+    forecast_.Append(dates[i], prices[i]);
+  }
+
+  return true;
+}
+
+bool StockForecaster::ApproximateRollingPricesByLeastSquaresMethod(
+    int window_size, int horizon, int degree) {
+  return ApproximateRollingPricesByLeastSquaresMethod(
+      window_size, horizon, degree, forecast_, error_message_);
+}
+
+bool StockForecaster::ApproximateRollingPricesByLeastSquaresMethod(
+    int window_size, int horizon, int degree, TimeSeries& forecast,
+    std::string& error_message) const {
+  if (!CheckRollingWindow(window_size, horizon, error_message)) {
+    return false;
+  }
+
+  // a window of fewer points would fit a lower degree without a word
+  if (window_size <= degree) {
+    error_message = "Not enough data in the window for a polynomial of "
+                    "degree " + std::to_string(degree);
+    return false;
+  }
+
+  RollingLeastSquares polynomial(data_, degree);
+  for (int i = 0; i < window_size; ++i) {
+    polynomial.PushBack();
+  }
+
+  size_t first_idx = window_size - 1;
+  size_t total_count = data_.size() - horizon - first_idx;
+
+  forecast.Clear();
+  forecast.Reserve(total_count);
+  size_t progress_step = std::max<size_t>(total_count / 100, 1);
+  for (size_t i = first_idx; i + horizon < data_.size(); ++i) {
+    if ((i - first_idx) % progress_step == 0 &&
+        !ReportProgress(i - first_idx, total_count, error_message)) {
+      forecast.Clear();
+      return false;
+    }
+
+    if (i > first_idx) {
+      polynomial.PopFront();
+      polynomial.PushBack();
+    }
+
+    time_t date = data_.Dates()[i + horizon];
+    forecast.Append(date, polynomial.ApproximatePrice(date));
+
+    if (!CheckConditionNumber(polynomial.GetConditionNumber(),
+                              " on " + data_[i].date.ToString(),
+                              "lower the degree or widen the window",
+                              error_message)) {
+      forecast.Clear();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool StockForecaster::SimulatePricesByLeastSquaresMethod(
+    int dates_count, int future_days, int degree,
+    const SimulationSettings& settings, ThreadPool& pool) {
+  if (data_.empty()) {
+    error_message_ = "First you need to load the data";
+    return false;
+  }
+
+  if (dates_count < 2 || future_days < 1) {
+    error_message_ = "Nothing to simulate before the last data point";
+    return false;
+  }
+
+  const LeastSquaresPolynomial* polynomial = GetCheckedPolynomial(degree);
+  if (!polynomial) {
+    return false;
+  }
+
+  std::vector<double> trend(data_.size());
+  polynomial->ApproximatePrices(data_.Dates().data(), data_.size(),
+                                trend.data());
+
+  PriceSimulator simulator;
+  if (!simulator.Fit(data_, trend)) {
+    error_message_ = simulator.GetError();
+    return false;
+  }
+
+  time_t last_date = data_.Dates().back();
+  time_t interval_length =
+      (data_.back().date.AddDays(future_days) - last_date) / (dates_count - 1);
+  std::vector<time_t> dates(dates_count);
+  for (int i = 0; i < dates_count; ++i) {
+    dates[i] = last_date + i * interval_length;
+  }
+  trend.resize(dates.size());
+  polynomial->ApproximatePrices(dates.data(), dates.size(), trend.data());
+
+  forecast_bands_.clear();
+  if (!simulator.Simulate(dates, trend, settings, pool, forecast_bands_,
+                          [this](size_t done_count, size_t total_count) {
+                            return ReportProgress(done_count, total_count,
+                                                  error_message_);
+                          })) {
+    error_message_ = simulator.GetError();
+    return false;
   }
 
   return true;
 }
 
-time_t StockForecaster::GetMaxDate() const {
-  return data_.back().date.ToTime_t();
+void StockForecaster::FitModels(int degree) {
+  if (!data_.empty()) {
+    GetFittedSpline();
+    GetFittedPolynomial(degree);
+  }
+}
+
+void StockForecaster::TrackTrend(int degree, double forgetting_factor,
+                                 size_t window_size) {
+  trend_.emplace(degree, forgetting_factor, window_size);
+  FitTrackedTrend();
 }
 
-time_t StockForecaster::GetMinDate() const {
-  return data_.front().date.ToTime_t();
+bool StockForecaster::ApproximatePriceByTrackedTrend(time_t date) {
+  if (data_.empty()) {
+    error_message_ = "First you need to load the data";
+    return false;
+  }
+
+  if (!trend_) {
+    error_message_ = "First you need to start tracking the trend";
+    return false;
+  }
+
+  condition_number_ = trend_->GetConditionNumber();
+  if (!CheckConditionNumber(condition_number_, "", "lower the degree",
+                            error_message_)) {
+    return false;
+  }
+
+  forecast_price_ = trend_->ApproximatePrice(date);
+
+  return true;
+}
+
+void StockForecaster::SetProgressCallback(ProgressCallback callback) {
+  progress_callback_ = std::move(callback);
 }
 
+time_t StockForecaster::GetMaxDate() const { return data_.Dates().back(); }
+
+time_t StockForecaster::GetMinDate() const { return data_.Dates().front(); }
+
 const std::string& StockForecaster::GetError() const { return error_message_; }
 
+double StockForecaster::GetConditionNumber() const {
+  return condition_number_;
+}
+
 double StockForecaster::GetForecastPrice() const { return forecast_price_; }
 
-const std::vector<DataPoint>& StockForecaster::GetForecast() const {
-  return forecast_;
+const TimeSeries& StockForecaster::GetForecast() const { return forecast_; }
+
+const std::vector<TimeSeries>& StockForecaster::GetForecastBands() const {
+  return forecast_bands_;
 }
 
-const std::vector<DataPoint>& StockForecaster::GetData() const { return data_; }
+TimeSeries StockForecaster::TakeForecast() {
+  TimeSeries forecast = std::move(forecast_);
+  forecast_.Clear();
+  return forecast;
+}
 
-// COMMON METHODS
+const TimeSeries& StockForecaster::GetData() const { return data_; }
 
-std::vector<time_t> StockForecaster::DefineDates(int dates_count,
-                                                 time_t period) {
-  time_t interval_length = period / (dates_count - 1);
-  std::vector<time_t> dates;
+double StockForecaster::GetLoadThroughput() const { return load_throughput_; }
 
-  time_t date_i = data_.front().date.ToTime_t();  // X0
-  for (int i = 0; i < dates_count; ++i) {
-    dates.push_back(date_i);
-    date_i += interval_length;
-  }
+void StockForecaster::SetDataCacheEnabled(bool enabled) {
+  is_data_cache_enabled_ = enabled;
+}
 
-  return dates;
+size_t StockForecaster::GetSplineCacheHits() const {
+  return spline_cache_hits_;
 }
 
-std::vector<double> StockForecaster::SolveSle(Matrix& sle) {
-  int last_row = sle.size() - 1;
-  int last_col = sle.front().size() - 1;
+size_t StockForecaster::GetSplineCacheMisses() const {
+  return spline_cache_misses_;
+}
 
-  // forward elimination
-  int pivot_row = 0, pivot_col = 0;
-  while (pivot_row < last_row) {
-    for (int i = pivot_row + 1; i <= last_row; ++i) {
-      double multiplier = sle[i][pivot_col] / sle[pivot_row][pivot_col];
-      for (int j = pivot_col; j <= last_col; ++j) {
-        sle[i][j] -= sle[pivot_row][j] * multiplier;
-      }
-    }
+// COMMON METHODS
 
-    ++pivot_row;
-    ++pivot_col;
+bool StockForecaster::ParseCsv(const std::string& file_path, TimeSeries& data,
+                               size_t& file_size) {
+  MappedFile file(file_path);
+  if (!file.IsOpen()) {
+    error_message_ = "Unable to open file: " + file_path;
+    return false;
   }
+  file_size = file.Size();
+
+  const char* cursor = file.Data();
+  const char* end = file.Data() + file.Size();
+  data.Reserve(std::count(cursor, end, '\n'));
+
+  // skip header
+  cursor = NextLine(cursor, end);
+
+  while (cursor != end) {
+    const char* line_end = NextLine(cursor, end);
+    const char* line_last = line_end;
+    while (line_last != cursor &&
+           (line_last[-1] == '\n' || line_last[-1] == '\r')) {
+      --line_last;
+    }
+
+    if (line_last != cursor) {
+      const char* comma = std::find(cursor, line_last, ',');
+      TimePoint time_point = TimePoint::FromChars(cursor, comma);
+
+      double price;
+      if (comma == line_last || !ParsePrice(comma + 1, line_last, price) ||
+          !time_point.isValid()) {
+        error_message_ =
+            "File has invalid data: " + std::string(cursor, line_last);
+        return false;
+      }
+
+      time_t date = time_point.ToTime_t();
+      if (!data.empty() && date <= data.Dates().back()) {
+        error_message_ = "File data must be sorted in ascending order: " +
+                         std::string(cursor, line_last);
+        return false;
+      }
 
-  // back substitution
-  std::vector<double> solution = std::vector<double>(sle.size());
-  for (int i = last_row; i >= 0; --i) {
-    int j = last_col - 1;
-    for (; j > i; --j) {
-      sle[i][last_col] -= sle[i][j] * solution[j];
+      data.Append(date, price);
     }
 
-    solution[i] = sle[i][last_col] / sle[i][j];
+    cursor = line_end;
   }
 
-  return solution;
+  return true;
 }
 
-// INTERPOLATION METHODS
+const char* StockForecaster::NextLine(const char* cursor, const char* end) {
+  const char* line_end =
+      static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+  return line_end == nullptr ? end : line_end + 1;
+}
 
-std::array<std::vector<double>, 4>
-StockForecaster::DefineInterpolationCoefficients() {
-  std::vector<time_t> dx(data_.size());  // date intervals
-  std::vector<double> dy(data_.size());  // price intervals
-  for (int i = 1; i < data_.size(); ++i) {
-    dx[i] = data_[i].date.ToTime_t() - data_[i - 1].date.ToTime_t();
-    dy[i] = data_[i].price - data_[i - 1].price;
+bool StockForecaster::ParsePrice(const char* first, const char* last,
+                                 double& price) {
+  while (first != last && (*first == ' ' || *first == '\t')) {
+    ++first;
   }
 
-  // make SLE
-  Matrix sle(data_.size(), std::vector<double>(data_.size() + 1));
-  sle[0][0] = 1;
-  sle[data_.size() - 1][data_.size() - 1] = 1;
-  for (int i = 1; i < sle.size() - 1; ++i) {
-    sle[i][i - 1] = dx[i];
-    sle[i][i] = 2 * (dx[i] + dx[i + 1]);
-    sle[i][i + 1] = dx[i + 1];
-    sle[i].back() = 3.0 * (dy[i + 1] / dx[i + 1] - dy[i] / dx[i]);
+  if (first != last && *first == '+') {
+    ++first;
   }
 
-  // calculate coefficients
-  std::array<std::vector<double>, 4> coeffs;
-  coeffs[C] = SolveSle(sle);
-  coeffs[A] = std::vector<double>(data_.size());
-  coeffs[B] = std::vector<double>(data_.size());
-  coeffs[D] = std::vector<double>(data_.size());
+  return std::from_chars(first, last, price).ec == std::errc();
+}
 
-  coeffs[A].front() = data_.front().price;
-  for (int i = 1; i < data_.size(); ++i) {
-    coeffs[A][i] = data_[i].price;
-    coeffs[B][i] =
-        dy[i] / dx[i] + (2.0 * coeffs[C][i] + coeffs[C][i - 1]) / 3.0 * dx[i];
-    coeffs[D][i] = (coeffs[C][i] - coeffs[C][i - 1]) / (3.0 * dx[i]);
+bool StockForecaster::ReportProgress(size_t done_count, size_t total_count,
+                                     std::string& error_message) const {
+  int percent = static_cast<int>(100 * done_count / total_count);
+  if (progress_callback_ && !progress_callback_(percent)) {
+    error_message = "Forecast was cancelled";
+    return false;
   }
 
-  return coeffs;
+  return true;
 }
 
-int StockForecaster::DefinePivotDateIndex(time_t date) {
-  size_t pivot_date_idx = 0;
-  while (date > data_[pivot_date_idx].date.ToTime_t()) {
-    ++pivot_date_idx;
+bool StockForecaster::CheckRollingWindow(int window_size, int horizon,
+                                         std::string& error_message) const {
+  if (data_.empty()) {
+    error_message = "First you need to load the data";
+    return false;
   }
 
-  return pivot_date_idx;
+  if (window_size < 2 || horizon < 1 ||
+      static_cast<size_t>(window_size) + horizon > data_.size()) {
+    error_message = "Not enough data for the window and the horizon";
+    return false;
+  }
+
+  return true;
 }
 
-double StockForecaster::InterpolatePrice(
-    time_t date, const std::array<std::vector<double>, 4>& coeffs,
-    int pivot_date_idx) {
-  time_t delta = date - data_[pivot_date_idx].date.ToTime_t();
-  return coeffs[A][pivot_date_idx] + coeffs[B][pivot_date_idx] * delta +
-         coeffs[C][pivot_date_idx] * std::pow(delta, 2) +
-         coeffs[D][pivot_date_idx] * std::pow(delta, 3);
+std::vector<time_t> StockForecaster::DefineDates(int dates_count,
+                                                 time_t period) {
+  time_t interval_length = period / (dates_count - 1);
+  std::vector<time_t> dates;
+
+  time_t date_i = data_.Dates().front();  // X0
+  for (int i = 0; i < dates_count; ++i) {
+    dates.push_back(date_i);
+    date_i += interval_length;
+  }
+
+  return dates;
 }
 
-// APPROXIMATION METHODS
+// INTERPOLATION METHODS
 
-std::vector<double> StockForecaster::DefineApproximationCoefficients(
-    int degree) {
-  // make SLE
-  Matrix sle(degree + 1, std::vector<double>(degree + 2));
-  int last_col = sle.front().size() - 1;
-
-  // fill first line of X
-  sle[0][0] = data_.size();
-  for (int i = 1; i < last_col; ++i) {
-    double sum = 0.0;
-    for (int j = 0; j < data_.size(); ++j) {
-      sum += std::pow(data_[j].date.ToTime_t(), i);
-    }
+const CubicSpline& StockForecaster::GetFittedSpline() {
+  if (spline_version_ == data_version_) {
+    ++spline_cache_hits_;
+  } else {
+    spline_.Fit(data_, 0, data_.size());
+    spline_version_ = data_version_;
+    ++spline_cache_misses_;
+  }
+
+  return spline_;
+}
+
+// binary search for the first data point not earlier than date, dates past
+// the last data point are extrapolated by the last spline segment
+size_t StockForecaster::DefinePivotDateIndex(time_t date) {
+  const std::vector<time_t>& dates = data_.Dates();
+  return std::lower_bound(dates.begin(), dates.end() - 1, date) -
+         dates.begin();
+}
 
-    sle[0][i] = sum;
+// linear sweep from the previous pivot, O(n + m) in total for m sorted dates
+size_t StockForecaster::DefinePivotDateIndex(time_t date,
+                                             size_t prev_pivot_date_idx) {
+  const std::vector<time_t>& dates = data_.Dates();
+  size_t pivot_date_idx = prev_pivot_date_idx;
+  while (pivot_date_idx < dates.size() - 1 && date > dates[pivot_date_idx]) {
+    ++pivot_date_idx;
   }
 
-  // fill penault column (X with largest degree in each row)
-  for (int i = 1; i <= degree; ++i) {
-    double sum = 0.0;
-    for (int j = 0; j < data_.size(); ++j) {
-      sum += std::pow(data_[j].date.ToTime_t(), degree + i);
-    }
+  return pivot_date_idx;
+}
+
+// APPROXIMATION METHODS
 
-    sle[i][last_col - 1] = sum;
+const LeastSquaresPolynomial& StockForecaster::GetFittedPolynomial(
+    int degree) {
+  if (polynomial_version_ != data_version_ || polynomial_degree_ != degree) {
+    polynomial_ = LeastSquaresPolynomial(data_, degree);
+    polynomial_version_ = data_version_;
+    polynomial_degree_ = degree;
   }
 
-  // fill last column (Y)
-  for (int i = 0; i <= degree; ++i) {
-    double sum = 0.0;
-    for (int j = 0; j < data_.size(); ++j) {
-      sum += data_[j].price * std::pow(data_[j].date.ToTime_t(), i);
-    }
+  return polynomial_;
+}
 
-    sle[i][last_col] = sum;
+const LeastSquaresPolynomial* StockForecaster::GetCheckedPolynomial(
+    int degree) {
+  const LeastSquaresPolynomial& polynomial = GetFittedPolynomial(degree);
+  condition_number_ = polynomial.GetConditionNumber();
+  if (polynomial.GetDegree() < degree) {
+    error_message_ =
+        "Not enough data for a polynomial of degree " + std::to_string(degree);
+    return nullptr;
   }
 
-  // fill other cells
-  for (int i = 1; i <= degree; ++i) {
-    for (int j = 0; j < last_col - 1; ++j) {
-      sle[i][j] = sle[i - 1][j + 1];
-    }
+  if (!CheckConditionNumber(condition_number_, "", "lower the degree",
+                            error_message_)) {
+    return nullptr;
   }
 
-  return SolveSle(sle);
+  return &polynomial;
 }
 
-double StockForecaster::ApproximatePrice(time_t date,
-                                         std::vector<double> coeffs) {
-  double price = 0.0;
-  for (int j = 0; j < coeffs.size(); ++j) {
-    price += coeffs[j] * std::pow(date, j);
+void StockForecaster::FitTrackedTrend() {
+  if (!trend_) {
+    return;
   }
 
-  return price;
+  trend_->Reset();
+  for (size_t i = 0; i < data_.size(); ++i) {
+    trend_->Update(data_.Dates()[i], data_.Prices()[i]);
+  }
 }
@@ -3,53 +3,145 @@
 
 #include <array>
 #include <chrono>
+#include <functional>
+#include <optional>
 #include <vector>
 
+#include "cubic_spline.h"
 #include "data_point.h"
+#include "least_squares_polynomial.h"
+#include "price_simulator.h"
+#include "recursive_least_squares.h"
+#include "thread_pool.h"
+#include "time_series.h"
 
+// Rolling methods forecast walk-forward: every data point from the
+// window_size-th on is forecast from a fit over the window_size points
+// horizon points before it, and the forecast holds these prices at the
+// dates of the points forecast.
 class StockForecaster {
-  using Matrix = std::vector<std::vector<double>>;
-
-  enum CubicInterpolationCoefficients { A, B, C, D };
-
  public:
+  // receives the completed percentage of a batch forecast and returns false
+  // to cancel it; may be called from the thread running the forecast
+  using ProgressCallback = std::function<bool(int)>;
+
+  // reads the binary cache next to the CSV when it is current, or parses the
+  // CSV and writes the cache, see SeriesCache
   bool LoadData(const std::string& file_path);
+  // adds a bar later than the loaded data, a fitted spline is extended in
+  // place instead of being refitted over the whole data
+  bool Append(const DataPoint& data_point);
 
   bool InterpolatePriceByCubicSplineMethod(time_t date);
   bool InterpolatePricesByCubicSplineMethod(int dates_count);
 
+  bool InterpolateRollingPricesByCubicSplineMethod(int window_size,
+                                                   int horizon);
+  // into forecast and error_message instead of the members, so one model
+  // may run rolling forecasts with different settings on several threads
+  bool InterpolateRollingPricesByCubicSplineMethod(
+      int window_size, int horizon, TimeSeries& forecast,
+      std::string& error_message) const;
+
   bool ApproximatePriceByLeastSquaresMethod(time_t date, int degree);
   bool ApproximatePricesByLeastSquaresMethod(int dates_count, int future_days,
                                              int degree);
+  bool ApproximateRollingPricesByLeastSquaresMethod(int window_size,
+                                                    int horizon, int degree);
+  bool ApproximateRollingPricesByLeastSquaresMethod(
+      int window_size, int horizon, int degree, TimeSeries& forecast,
+      std::string& error_message) const;
+
+  // Monte Carlo price paths from the last data point future_days ahead
+  // around the least squares trend of the degree, see PriceSimulator; the
+  // percentile bands of the paths are kept by GetForecastBands()
+  bool SimulatePricesByLeastSquaresMethod(int dates_count, int future_days,
+                                          int degree,
+                                          const SimulationSettings& settings,
+                                          ThreadPool& pool);
+
+  // fits the spline and the least squares polynomial of the degree ahead of
+  // the queries, which then only evaluate them until the data changes
+  void FitModels(int degree);
+
+  // fits a least squares trend over the data and keeps it refreshed by every
+  // Append and LoadData in O(degree^2) per bar, see RecursiveLeastSquares
+  void TrackTrend(int degree, double forgetting_factor = 1.0,
+                  size_t window_size = 0);
+  bool ApproximatePriceByTrackedTrend(time_t date);
+
+  void SetProgressCallback(ProgressCallback callback);
 
   time_t GetMaxDate() const;
   time_t GetMinDate() const;
 
   const std::string& GetError() const;
+  // of the normal equations of the last least squares fit by the point,
+  // batch or simulation methods or the tracked trend, estimated in the
+  // 1-norm; the rolling methods check every window instead, see
+  // kMaxConditionNumber
+  double GetConditionNumber() const;
   double GetForecastPrice() const;
-  const std::vector<DataPoint>& GetForecast() const;
-  const std::vector<DataPoint>& GetData() const;
+  const TimeSeries& GetForecast() const;
+  // one per percentile of the settings of the last simulation
+  const std::vector<TimeSeries>& GetForecastBands() const;
+  // moves the last forecast out without copying, GetForecast() is empty after
+  TimeSeries TakeForecast();
+  const TimeSeries& GetData() const;
+  // MB/s of the CSV of the last successful LoadData, parsed or cached
+  double GetLoadThroughput() const;
+  void SetDataCacheEnabled(bool enabled);  // enabled by default
+
+  size_t GetSplineCacheHits() const;
+  size_t GetSplineCacheMisses() const;
 
  private:
   // common
+  bool ParseCsv(const std::string& file_path, TimeSeries& data,
+                size_t& file_size);
+  static const char* NextLine(const char* cursor, const char* end);
+  static bool ParsePrice(const char* first, const char* last, double& price);
+  bool ReportProgress(size_t done_count, size_t total_count,
+                      std::string& error_message) const;
   std::vector<time_t> DefineDates(int dates_count, time_t period);
-  std::vector<double> SolveSle(Matrix& sle);
-
-  // Interpolation
-  std::array<std::vector<double>, 4> DefineInterpolationCoefficients();
-  int DefinePivotDateIndex(time_t date);
-  double InterpolatePrice(time_t date,
-                          const std::array<std::vector<double>, 4>& coeffs,
-                          int pivot_date_idx);
+  bool CheckRollingWindow(int window_size, int horizon,
+                          std::string& error_message) const;
 
   // Approximation
-  std::vector<double> DefineApproximationCoefficients(int degree);
-  double ApproximatePrice(time_t date, std::vector<double> coeffs);
+  const LeastSquaresPolynomial& GetFittedPolynomial(int degree);
+  // the fitted polynomial, or nullptr with the error when the data defines
+  // a lower degree only or the fit is too ill-conditioned to trust
+  const LeastSquaresPolynomial* GetCheckedPolynomial(int degree);
+  void FitTrackedTrend();
+
+  // Interpolation
+  const CubicSpline& GetFittedSpline();
+  size_t DefinePivotDateIndex(time_t date);
+  size_t DefinePivotDateIndex(time_t date, size_t prev_pivot_date_idx);
 
   std::string error_message_;
+  ProgressCallback progress_callback_;
   double forecast_price_ = 0.0;
-  std::vector<DataPoint> forecast_;
-  std::vector<DataPoint> data_;
+  double condition_number_ = 1.0;
+  TimeSeries forecast_;
+  std::vector<TimeSeries> forecast_bands_;
+  TimeSeries data_;
+  size_t data_version_ = 0;
+  double load_throughput_ = 0.0;
+  bool is_data_cache_enabled_ = true;
+
+  // spline is refitted only when data_version_ changes
+  CubicSpline spline_;
+  size_t spline_version_ = 0;
+  size_t spline_cache_hits_ = 0;
+  size_t spline_cache_misses_ = 0;
+
+  // and the polynomial when data_version_ or the degree changes
+  LeastSquaresPolynomial polynomial_;
+  size_t polynomial_version_ = 0;
+  int polynomial_degree_ = 0;
+
+  std::optional<RecursiveLeastSquares> trend_;
 };
 
 #endif  // ALGORITHMIC_TRADING_MODEL_STOCKFORECASTER_H
@@ -0,0 +1,174 @@
+#include "thread_pool.h"
+
+namespace {
+
+// the pool and the deque of the worker running on this thread
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local size_t current_worker_idx = 0;
+
+}  // namespace
+
+ThreadPool::ThreadPool(size_t threads_count) {
+  threads_count = threads_count > 0 ? threads_count : 1;
+  queues_.reserve(threads_count);
+  for (size_t i = 0; i < threads_count; ++i) {
+    queues_.push_back(std::make_unique<TaskQueue>());
+  }
+
+  workers_.reserve(threads_count);
+  for (size_t i = 0; i < threads_count; ++i) {
+    workers_.emplace_back(&ThreadPool::Work, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  condition_.notify_all();
+
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+size_t ThreadPool::GetThreadsCount() const { return workers_.size(); }
+
+size_t ThreadPool::DefaultThreadsCount() {
+  size_t threads_count = std::thread::hardware_concurrency();
+  return threads_count > 0 ? threads_count : 1;
+}
+
+void ThreadPool::Push(std::function<void()> task) {
+  size_t queue_idx =
+      current_pool == this
+          ? current_worker_idx
+          : next_queue_idx_.fetch_add(1, std::memory_order_relaxed) %
+                queues_.size();
+  {
+    std::lock_guard<std::mutex> lock(queues_[queue_idx]->mutex);
+    queues_[queue_idx]->tasks.push_back(std::move(task));
+  }
+
+  // a worker counts itself asleep before it checks for tasks, and the
+  // count is read after the task is counted, so either the worker sees the
+  // task or the push sees the worker; the lock waits for it to fall asleep
+  queued_count_.fetch_add(1);
+  if (sleeping_count_.load() > 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    condition_.notify_one();
+  }
+}
+
+// the newest task of the own deque, or else the oldest of another
+std::function<void()> ThreadPool::Pop(size_t worker_idx) {
+  for (size_t i = 0; i < queues_.size(); ++i) {
+    TaskQueue& queue = *queues_[(worker_idx + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      continue;
+    }
+
+    std::function<void()> task;
+    if (i == 0) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    } else {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+    queued_count_.fetch_sub(1);
+    return task;
+  }
+
+  return nullptr;
+}
+
+void ThreadPool::Work(size_t worker_idx) {
+  current_pool = this;
+  current_worker_idx = worker_idx;
+
+  while (true) {
+    if (std::function<void()> task = Pop(worker_idx)) {
+      task();
+      continue;
+    }
+
+    // a task counted but not found is being popped by another worker
+    std::unique_lock<std::mutex> lock(mutex_);
+    sleeping_count_.fetch_add(1);
+    condition_.wait(lock,
+                    [this]() { return stopping_ || queued_count_.load() > 0; });
+    sleeping_count_.fetch_sub(1);
+    if (stopping_ && queued_count_.load() == 0) {
+      return;
+    }
+  }
+}
+
+ThreadPool::TaskGroup::TaskGroup(ThreadPool& pool)
+    : pool_(pool), state_(std::make_shared<State>()) {}
+
+ThreadPool::TaskGroup::~TaskGroup() { WaitUnfinished(); }
+
+void ThreadPool::TaskGroup::Run(std::function<void()> task) {
+  auto shared_task = std::make_shared<Task>();
+  shared_task->function = std::move(task);
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    ++state_->unfinished_count;
+  }
+  tasks_.push_back(shared_task);
+
+  pool_.Push(
+      [shared_task, state = state_]() { RunOnce(*shared_task, *state); });
+}
+
+void ThreadPool::TaskGroup::Wait() {
+  WaitUnfinished();
+
+  std::exception_ptr exception;
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    std::swap(exception, state_->exception);
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+// newest first, as the own deque of a worker, while others steal the oldest
+void ThreadPool::TaskGroup::WaitUnfinished() {
+  for (auto task = tasks_.rbegin(); task != tasks_.rend(); ++task) {
+    RunOnce(**task, *state_);
+  }
+  tasks_.clear();
+
+  std::unique_lock<std::mutex> lock(state_->mutex);
+  state_->condition.wait(
+      lock, [this]() { return state_->unfinished_count == 0; });
+}
+
+void ThreadPool::TaskGroup::RunOnce(Task& task, State& state) {
+  if (task.is_claimed.exchange(true)) {
+    return;
+  }
+
+  // caught here rather than let out of a worker, where it would terminate
+  // the process, or out of the waiter before the other tasks finish
+  std::exception_ptr exception;
+  try {
+    task.function();
+  } catch (...) {
+    exception = std::current_exception();
+  }
+
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (exception && !state.exception) {
+    state.exception = exception;
+  }
+  if (--state.unfinished_count == 0) {
+    state.condition.notify_all();
+  }
+}
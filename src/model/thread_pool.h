@@ -0,0 +1,111 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_THREADPOOL_H
+#define ALGORITHMIC_TRADING_MODEL_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of worker threads with a task deque each. Tasks submitted from
+// outside are dealt round-robin over the deques, and tasks submitted by a
+// worker go to its own deque, which it runs newest first while the tasks
+// are still in cache. A worker out of tasks steals the oldest task of
+// another, so uneven tasks, such as the series of very different lengths,
+// keep every worker busy until the last one. Only the touched deque is
+// locked, and a worker with nothing to run sleeps until a push wakes it.
+class ThreadPool {
+ public:
+  explicit ThreadPool(size_t threads_count = DefaultThreadsCount());
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool();
+
+  // tasks run on the pool and waited for together. The waiting thread runs
+  // the tasks of the group no worker has started yet and sleeps until the
+  // rest finish, so a task may wait for its own subtasks without tying up
+  // a worker, and without running tasks that are not its own. A task that
+  // throws still counts as finished, and Wait() rethrows the first exception
+  // once every task is done
+  class TaskGroup {
+   public:
+    explicit TaskGroup(ThreadPool& pool);
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    ~TaskGroup();  // waits, dropping an exception no Wait() has rethrown
+
+    void Run(std::function<void()> task);
+    void Wait();
+
+   private:
+    struct Task {
+      std::function<void()> function;
+      std::atomic<bool> is_claimed{false};  // by a worker or the waiter
+    };
+    struct State {
+      std::mutex mutex;
+      std::condition_variable condition;
+      size_t unfinished_count = 0;
+      std::exception_ptr exception;  // the first one thrown by a task
+    };
+
+    // runs the task unless a worker or the waiter already claimed it
+    static void RunOnce(Task& task, State& state);
+    void WaitUnfinished();
+
+    // shared with the queued copies, which outlive the group when the waiter
+    // ran their tasks before a worker reached them
+    ThreadPool& pool_;
+    std::vector<std::shared_ptr<Task>> tasks_;
+    std::shared_ptr<State> state_;
+  };
+
+  template <typename Task>
+  std::future<std::invoke_result_t<Task>> Submit(Task&& task);
+
+  size_t GetThreadsCount() const;
+  static size_t DefaultThreadsCount();
+
+ private:
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void Push(std::function<void()> task);
+  // empty when every deque is
+  std::function<void()> Pop(size_t worker_idx);
+  void Work(size_t worker_idx);
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;  // one per worker
+  std::vector<std::thread> workers_;
+  std::atomic<size_t> next_queue_idx_{0};
+  std::atomic<size_t> queued_count_{0};  // tasks pushed and not yet popped
+
+  // guard the sleep of the idle workers, so a push never misses one
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::atomic<size_t> sleeping_count_{0};
+  bool stopping_ = false;
+};
+
+template <typename Task>
+std::future<std::invoke_result_t<Task>> ThreadPool::Submit(Task&& task) {
+  using Result = std::invoke_result_t<Task>;
+
+  // std::function needs a copyable callable, std::packaged_task is move-only
+  auto packaged_task =
+      std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+  std::future<Result> result = packaged_task->get_future();
+  Push([packaged_task]() { (*packaged_task)(); });
+
+  return result;
+}
+
+#endif  // ALGORITHMIC_TRADING_MODEL_THREADPOOL_H
@@ -1,54 +1,85 @@
 #include "time_point.h"
 
-#include <iomanip>
-
-TimePoint::TimePoint(std::string& date) {
-  std::tm tm{};
-  std::istringstream ss(date);
-  ss >> std::get_time(&tm, "%Y-%m-%d");
-
-  if (!ss.fail()) {
-    std::time_t time = std::mktime(&tm);
-    data_ = std::chrono::high_resolution_clock::from_time_t(time);
-    isValid_ = true;
-  } else {
-    isValid_ = false;
+#include <cstdio>
+
+TimePoint::TimePoint(const std::string& date)
+    : TimePoint(FromChars(date.data(), date.data() + date.size())) {}
+
+TimePoint::TimePoint(time_t time) : seconds_(time) {}
+
+TimePoint TimePoint::FromChars(const char* first, const char* last) {
+  auto read_number = [&first, last](int max_digits, unsigned& value) {
+    const char* start = first;
+    value = 0;
+    while (first != last && first - start < max_digits && *first >= '0' &&
+           *first <= '9') {
+      value = value * 10 + (*first++ - '0');
+    }
+
+    return first != start;
+  };
+
+  auto skip_dash = [&first, last]() {
+    return first != last && *first++ == '-';
+  };
+
+  unsigned year = 0, month = 0, day = 0;
+  TimePoint time_point;
+  if (read_number(4, year) && skip_dash() && read_number(2, month) &&
+      skip_dash() && read_number(2, day) && first == last) {
+    static constexpr unsigned kDaysInMonth[] = {31, 28, 31, 30, 31, 30,
+                                                31, 31, 30, 31, 30, 31};
+    bool is_leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+    if (month >= 1 && month <= 12 && day >= 1 &&
+        day <= kDaysInMonth[month - 1] + (month == 2 && is_leap)) {
+      time_point.seconds_ = DaysFromCivil(year, month, day) * 24 * 60 * 60;
+    }
   }
-}
 
-TimePoint::TimePoint(time_t time)
-    : data_(std::chrono::high_resolution_clock::from_time_t(time)),
-      isValid_(true) {}
+  return time_point;
+}
 
 std::string TimePoint::ToString() const {
-  if (!isValid_) {
+  if (!isValid()) {
     return "(null)";
   }
 
-  auto time = std::chrono::high_resolution_clock::to_time_t(data_);
-  std::tm tm = *std::localtime(&time);
-  std::ostringstream ss;
-  ss << std::put_time(&tm, "%Y-%m-%d");
+  // floor division, so times before 1970 fall on their own day
+  const time_t kSecondsPerDay = 24 * 60 * 60;
+  time_t days =
+      seconds_ / kSecondsPerDay - (seconds_ % kSecondsPerDay < 0);
 
-  return ss.str();
-}
+  int year;
+  unsigned month, day;
+  CivilFromDays(days, year, month, day);
+  if (year < 0 || year > 9999) {
+    char text[32];
+    int length = std::snprintf(text, sizeof(text), "%d-%02u-%02u", year,
+                               month, day);
+    return std::string(text, length);
+  }
 
-double TimePoint::ToDouble() const {
-  return std::chrono::duration<double>(data_.time_since_epoch()).count();
+  char text[10] = {
+      static_cast<char>('0' + year / 1000),
+      static_cast<char>('0' + year / 100 % 10),
+      static_cast<char>('0' + year / 10 % 10),
+      static_cast<char>('0' + year % 10),
+      '-',
+      static_cast<char>('0' + month / 10),
+      static_cast<char>('0' + month % 10),
+      '-',
+      static_cast<char>('0' + day / 10),
+      static_cast<char>('0' + day % 10),
+  };
+  return std::string(text, sizeof(text));
 }
 
-time_t TimePoint::ToTime_t() const {
-  return std::chrono::high_resolution_clock::to_time_t(data_);
-}
+double TimePoint::ToDouble() const { return static_cast<double>(seconds_); }
+
+time_t TimePoint::ToTime_t() const { return seconds_; }
 
 time_t TimePoint::AddDays(int days) const {
-  return std::chrono::high_resolution_clock::to_time_t(
-      data_ + std::chrono::hours(days * 24));
+  return seconds_ + static_cast<int64_t>(days) * 24 * 60 * 60;
 }
 
-bool TimePoint::isValid() const { return isValid_; }
-
-std::chrono::time_point<std::chrono::high_resolution_clock>&
-TimePoint::Value() {
-  return data_;
-}
+bool TimePoint::isValid() const { return seconds_ != kInvalid; }
@@ -1,24 +1,74 @@
 #ifndef ALGORITHMIC_TRADING_MODEL_TIMEPOINT_H
 #define ALGORITHMIC_TRADING_MODEL_TIMEPOINT_H
 
-#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <limits>
 #include <string>
+#include <type_traits>
 
+// Dates are UTC throughout: parsing and formatting go through the civil
+// calendar arithmetic below instead of the C library, so they need neither
+// the locale nor the time zone database and are safe on any thread. A time
+// point is a single count of seconds with an in-band invalid value, so it
+// is trivially copyable and a DataPoint packs into 16 bytes.
 class TimePoint {
  public:
-  TimePoint(time_t time);
-  TimePoint(std::string& date);
+  TimePoint(time_t time);  // the seconds of kInvalid make an invalid point
+  TimePoint(const std::string& date);
 
+  // parses YYYY-MM-DD in place as a UTC date, without locale or allocations
+  static TimePoint FromChars(const char* first, const char* last);
+
+  // days since 1970-01-01 in the proleptic Gregorian calendar
+  static constexpr long long DaysFromCivil(int year, unsigned month,
+                                           unsigned day) {
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned year_of_era = static_cast<unsigned>(year - era * 400);
+    const unsigned day_of_year =
+        (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 -
+                                year_of_era / 100 + day_of_year;
+    return era * 146097LL + static_cast<long long>(day_of_era) - 719468;
+  }
+
+  // the inverse of DaysFromCivil
+  static constexpr void CivilFromDays(long long days, int& year,
+                                      unsigned& month, unsigned& day) {
+    days += 719468;
+    const long long era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned day_of_era = static_cast<unsigned>(days - era * 146097);
+    const unsigned year_of_era =
+        (day_of_era - day_of_era / 1460 + day_of_era / 36524 -
+         day_of_era / 146096) /
+        365;
+    const unsigned day_of_year =
+        day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const unsigned month_index = (5 * day_of_year + 2) / 153;
+    day = day_of_year - (153 * month_index + 2) / 5 + 1;
+    month = month_index < 10 ? month_index + 3 : month_index - 9;
+    year = static_cast<int>(year_of_era + era * 400) + (month <= 2);
+  }
+
+  // YYYY-MM-DD of the UTC day, short enough for the small string buffer
   std::string ToString() const;
   time_t ToTime_t() const;
   time_t AddDays(int days) const;
   double ToDouble() const;
   bool isValid() const;
-  std::chrono::time_point<std::chrono::high_resolution_clock>& Value();
 
  private:
-  std::chrono::time_point<std::chrono::high_resolution_clock> data_;
-  bool isValid_;
+  // far before any date FromChars can parse
+  static constexpr int64_t kInvalid = std::numeric_limits<int64_t>::min();
+
+  TimePoint() : seconds_(kInvalid) {}
+
+  int64_t seconds_;  // since 1970-01-01 00:00 UTC
 };
 
+static_assert(sizeof(TimePoint) == 8 &&
+                  std::is_trivially_copyable_v<TimePoint>,
+              "TimePoint must stay a plain 8-byte value");
+
 #endif  // ALGORITHMIC_TRADING_MODEL_TIMEPOINT_H
@@ -0,0 +1,40 @@
+#include "time_series.h"
+
+void TimeSeries::Reserve(size_t size) {
+  dates_.reserve(size);
+  prices_.reserve(size);
+}
+
+void TimeSeries::Append(time_t date, double price) {
+  dates_.push_back(date);
+  prices_.push_back(price);
+}
+
+void TimeSeries::Clear() {
+  dates_.clear();
+  prices_.clear();
+}
+
+size_t TimeSeries::size() const { return dates_.size(); }
+
+bool TimeSeries::empty() const { return dates_.empty(); }
+
+DataPoint TimeSeries::operator[](size_t idx) const {
+  return DataPoint(dates_[idx], prices_[idx]);
+}
+
+DataPoint TimeSeries::front() const { return (*this)[0]; }
+
+DataPoint TimeSeries::back() const { return (*this)[size() - 1]; }
+
+TimeSeries::ConstIterator TimeSeries::begin() const {
+  return ConstIterator(this, 0);
+}
+
+TimeSeries::ConstIterator TimeSeries::end() const {
+  return ConstIterator(this, size());
+}
+
+const std::vector<time_t>& TimeSeries::Dates() const { return dates_; }
+
+const std::vector<double>& TimeSeries::Prices() const { return prices_; }
@@ -0,0 +1,62 @@
+#ifndef ALGORITHMIC_TRADING_MODEL_TIMESERIES_H
+#define ALGORITHMIC_TRADING_MODEL_TIMESERIES_H
+
+#include <iterator>
+#include <vector>
+
+#include "data_point.h"
+
+// Price series stored as a structure of arrays: contiguous timestamps and
+// contiguous prices. Fitting and evaluation loops work on the raw columns,
+// while the row interface yields DataPoint values for the view.
+class TimeSeries {
+ public:
+  class ConstIterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = DataPoint;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = DataPoint;
+
+    ConstIterator(const TimeSeries* series, size_t idx)
+        : series_(series), idx_(idx) {}
+
+    DataPoint operator*() const { return (*series_)[idx_]; }
+    ConstIterator& operator++() {
+      ++idx_;
+      return *this;
+    }
+    bool operator==(const ConstIterator& other) const {
+      return idx_ == other.idx_;
+    }
+    bool operator!=(const ConstIterator& other) const {
+      return idx_ != other.idx_;
+    }
+
+   private:
+    const TimeSeries* series_;
+    size_t idx_;
+  };
+
+  void Reserve(size_t size);
+  void Append(time_t date, double price);
+  void Clear();
+
+  size_t size() const;
+  bool empty() const;
+  DataPoint operator[](size_t idx) const;
+  DataPoint front() const;
+  DataPoint back() const;
+  ConstIterator begin() const;
+  ConstIterator end() const;
+
+  const std::vector<time_t>& Dates() const;
+  const std::vector<double>& Prices() const;
+
+ private:
+  std::vector<time_t> dates_;
+  std::vector<double> prices_;
+};
+
+#endif  // ALGORITHMIC_TRADING_MODEL_TIMESERIES_H
@@ -0,0 +1,86 @@
+#include "graph_decimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+GraphDecimator::GraphDecimator(QCPGraph* graph, TimeSeries series)
+    : QObject(graph), graph_(graph), series_(std::move(series)) {
+  connect(graph_->parentPlot(), &QCustomPlot::beforeReplot, this,
+          &GraphDecimator::Update);
+
+  // whole series first, the extremes are kept so axes rescale correctly
+  if (!series_.empty()) {
+    Decimate(series_.Dates().front(), series_.Dates().back(),
+             graph_->keyAxis()->axisRect()->width());
+  }
+}
+
+void GraphDecimator::Update() {
+  QCPRange range = graph_->keyAxis()->range();
+  int buckets_count = graph_->keyAxis()->axisRect()->width();
+  if (series_.empty() || (range == range_ && buckets_count == buckets_count_)) {
+    return;
+  }
+
+  range_ = range;
+  buckets_count_ = buckets_count;
+  Decimate(range.lower, range.upper, buckets_count);
+}
+
+void GraphDecimator::Decimate(double lower_key, double upper_key,
+                              int buckets_count) {
+  const std::vector<time_t>& dates = series_.Dates();
+  const std::vector<double>& prices = series_.Prices();
+  buckets_count = std::max(buckets_count, 1);
+
+  // visible points plus one neighbour on each side, so lines reach the edges
+  size_t first =
+      std::lower_bound(dates.begin(), dates.end(), lower_key) - dates.begin();
+  size_t last =
+      std::upper_bound(dates.begin(), dates.end(), upper_key) - dates.begin();
+  first = first > 0 ? first - 1 : 0;
+  last = std::min(last + 1, dates.size());
+
+  QVector<QCPGraphData> points;
+  if (last - first <= 4 * static_cast<size_t>(buckets_count)) {
+    points.reserve(last - first);
+    for (size_t i = first; i < last; ++i) {
+      points.append(QCPGraphData(dates[i], prices[i]));
+    }
+  } else {
+    points.reserve(4 * buckets_count + 2);
+    double bucket_width = (upper_key - lower_key) / buckets_count;
+
+    size_t i = first;
+    while (i < last) {
+      // bucket of the point i, points outside the visible range get their own
+      double bucket_end =
+          dates[i] < lower_key || dates[i] > upper_key
+              ? dates[i]
+              : lower_key +
+                    (std::floor((dates[i] - lower_key) / bucket_width) + 1) *
+                        bucket_width;
+
+      size_t bucket_first = i, min_idx = i, max_idx = i;
+      for (++i; i < last && dates[i] < bucket_end; ++i) {
+        min_idx = prices[i] < prices[min_idx] ? i : min_idx;
+        max_idx = prices[i] > prices[max_idx] ? i : max_idx;
+      }
+      size_t bucket_last = i - 1;
+
+      size_t indexes[] = {bucket_first, std::min(min_idx, max_idx),
+                          std::max(min_idx, max_idx), bucket_last};
+      size_t prev_idx = last;
+      for (size_t idx : indexes) {
+        if (idx != prev_idx) {
+          points.append(QCPGraphData(dates[idx], prices[idx]));
+          prev_idx = idx;
+        }
+      }
+    }
+  }
+
+  // the container adopts the implicitly shared vector as its storage, and
+  // since the keys are ascending it neither copies nor sorts them
+  graph_->data()->set(points, true);
+}
@@ -0,0 +1,33 @@
+#ifndef ALGORITHMIC_TRADING_GRAPHDECIMATOR_H
+#define ALGORITHMIC_TRADING_GRAPHDECIMATOR_H
+
+#include <QObject>
+
+#include "../../libs/qcustomplot.h"
+#include "../model/time_series.h"
+
+// Keeps the full series of a graph and hands QCustomPlot only what can be
+// seen: before every replot the visible key range is split into one bucket
+// per pixel and each bucket is reduced to its first, min, max and last
+// points (M4 decimation), which draws the same picture as the full series
+// while the graph holds at most four points per pixel.
+class GraphDecimator : public QObject {
+  Q_OBJECT
+
+ public:
+  // the decimator is owned by the graph and removed along with it
+  GraphDecimator(QCPGraph* graph, TimeSeries series);
+
+ private slots:
+  void Update();
+
+ private:
+  void Decimate(double lower_key, double upper_key, int buckets_count);
+
+  QCPGraph* graph_;
+  TimeSeries series_;
+  QCPRange range_;
+  int buckets_count_ = 0;
+};
+
+#endif  // ALGORITHMIC_TRADING_GRAPHDECIMATOR_H
@@ -1,5 +1,8 @@
 #include "mainwindow.h"
 
+#include <QTimeZone>
+#include <QtConcurrent/QtConcurrent>
+
 #include "../view/ui_mainwindow.h"
 #include "QFileDialog"
 #include "QMessageBox"
@@ -13,9 +16,23 @@ MainWindow::MainWindow(QWidget* parent)
   HideLegend(ui_->apnLegend);
   InitPlot(ui_->ipnPlot);
   InitPlot(ui_->apnPlot);
+  ui_->forecastProgressBar->setVisible(false);
+
+  // progress is reported from the worker thread, so the connection is queued
+  model_->SetProgressCallback([this](int percent) {
+    emit ForecastProgressChanged(percent);
+    return !forecast_cancelled_;
+  });
+  connect(this, &MainWindow::ForecastProgressChanged,
+          ui_->forecastProgressBar, &QProgressBar::setValue);
+  connect(&forecast_watcher_, &QFutureWatcher<bool>::finished, this,
+          &MainWindow::OnForecastFinished);
 }
 
 MainWindow::~MainWindow() {
+  // the worker holds the model, the cancelled job ends at its next report
+  CancelForecast();
+  forecast_watcher_.waitForFinished();
   delete ui_;
   delete model_;
 }
@@ -23,29 +40,28 @@ MainWindow::~MainWindow() {
 void MainWindow::on_loadDataBtn_clicked() {
   QString filename =
       QFileDialog::getOpenFileName(this, "Load data", ".", "*.csv");
-  if (!filename.isEmpty()) {
-    if (model_->LoadData(filename.toStdString())) {
-      QMessageBox::information(this, "Notice", "Data loaded successfully",
-                               QMessageBox::Ok);
-      ui_->fileNameLabel->setText(filename);
-      InitControlPanel();
-      on_apnClearCanvasBtn_clicked();
-      on_ipnClearCanvasBtn_clicked();
-    } else {
-      QMessageBox::critical(this, "Error",
-                            QString::fromStdString(model_->GetError()),
-                            QMessageBox::Ok);
-    }
+  if (filename.isEmpty()) {
+    return;
+  }
+
+  // the worker holds the model, the file is loaded once it lets go
+  if (forecast_watcher_.isRunning()) {
+    CancelForecast();
+    pending_file_name_ = filename;
+    return;
   }
+
+  LoadData(filename);
 }
 
-void MainWindow::on_ipnDrawGraphBtn_clicked() {
-  if (model_->InterpolatePricesByCubicSplineMethod(
-          ui_->ipnPointsCountSpinBox->value())) {
-    DrawInterpolationGraph();
-    if (ui_->ipnPlot->graphCount() == kMaxPlotsCount) {
-      ui_->ipnDrawGraphBtn->setDisabled(true);
-    }
+void MainWindow::LoadData(const QString& filename) {
+  if (model_->LoadData(filename.toStdString())) {
+    QMessageBox::information(this, "Notice", "Data loaded successfully",
+                             QMessageBox::Ok);
+    ui_->fileNameLabel->setText(filename);
+    InitControlPanel();
+    on_apnClearCanvasBtn_clicked();
+    on_ipnClearCanvasBtn_clicked();
   } else {
     QMessageBox::critical(this, "Error",
                           QString::fromStdString(model_->GetError()),
@@ -53,34 +69,76 @@ void MainWindow::on_ipnDrawGraphBtn_clicked() {
   }
 }
 
+void MainWindow::on_ipnDrawGraphBtn_clicked() {
+  int dates_count = ui_->ipnPointsCountSpinBox->value();
+  RunForecast(
+      ui_->ipnPlot,
+      [this, dates_count]() {
+        return model_->InterpolatePricesByCubicSplineMethod(dates_count);
+      },
+      &MainWindow::OnInterpolationReady);
+}
+
 void MainWindow::on_apnDrawGraphBtn_clicked() {
-  if (model_->ApproximatePricesByLeastSquaresMethod(
-          ui_->apnPointsCountSpinBox->value(),
-          ui_->apnDaysCountSpinBox->value(),
-          ui_->apnPolyDegreeSpinBox->value())) {
-    DrawApproximationGraph();
-    if (ui_->apnPlot->graphCount() == kMaxPlotsCount + 1) {
-      ui_->apnDrawGraphBtn->setDisabled(true);
-    }
-  } else {
-    QMessageBox::critical(this, "Error",
-                          QString::fromStdString(model_->GetError()),
-                          QMessageBox::Ok);
+  int dates_count = ui_->apnPointsCountSpinBox->value();
+  int future_days = ui_->apnDaysCountSpinBox->value();
+  int degree = ui_->apnPolyDegreeSpinBox->value();
+  RunForecast(
+      ui_->apnPlot,
+      [this, dates_count, future_days, degree]() {
+        return model_->ApproximatePricesByLeastSquaresMethod(
+            dates_count, future_days, degree);
+      },
+      &MainWindow::OnApproximationReady);
+}
+
+void MainWindow::on_apnSimulateBtn_clicked() {
+  // a point a day from the last data point
+  int future_days = ui_->apnDaysCountSpinBox->value();
+  int degree = ui_->apnPolyDegreeSpinBox->value();
+  if (!simulation_pool_) {
+    simulation_pool_ = std::make_unique<ThreadPool>();
+  }
+  RunForecast(
+      ui_->apnPlot,
+      [this, future_days, degree]() {
+        return model_->SimulatePricesByLeastSquaresMethod(
+            future_days + 1, future_days, degree, simulation_settings_,
+            *simulation_pool_);
+      },
+      &MainWindow::OnSimulationReady);
+}
+
+void MainWindow::OnInterpolationReady() {
+  DrawInterpolationGraph();
+  if (ui_->ipnPlot->graphCount() == kMaxPlotsCount) {
+    ui_->ipnDrawGraphBtn->setDisabled(true);
   }
 }
 
+void MainWindow::OnApproximationReady() {
+  DrawApproximationGraph();
+  if (ui_->apnPlot->graphCount() == kMaxPlotsCount + 1) {
+    ui_->apnDrawGraphBtn->setDisabled(true);
+  }
+}
+
+void MainWindow::OnSimulationReady() { DrawSimulationBands(); }
+
 void MainWindow::on_ipnClearCanvasBtn_clicked() {
+  CancelForecast(ui_->ipnPlot);
   ui_->ipnPlot->clearGraphs();
   HideLegend(ui_->ipnLegend);
-  ui_->ipnDrawGraphBtn->setEnabled(true);
+  ui_->ipnDrawGraphBtn->setEnabled(!forecast_watcher_.isRunning());
   ui_->ipnPointsCountSpinBox->setValue(0);
   ui_->ipnPlot->replot();
 }
 
 void MainWindow::on_apnClearCanvasBtn_clicked() {
-  ui_->apnPlot->clearGraphs();
+  CancelForecast(ui_->apnPlot);
+  ui_->apnPlot->clearPlottables();  // the graphs and the simulated bands
   HideLegend(ui_->apnLegend);
-  ui_->apnDrawGraphBtn->setEnabled(true);
+  ui_->apnDrawGraphBtn->setEnabled(!forecast_watcher_.isRunning());
   ui_->apnPointsCountSpinBox->setValue(0);
   ui_->apnPlot->replot();
 }
@@ -108,6 +166,69 @@ void MainWindow::on_apnForecastBtn_clicked() {
   }
 }
 
+void MainWindow::RunForecast(QCustomPlot* plot,
+                             const std::function<bool()>& forecast,
+                             void (MainWindow::*on_ready)()) {
+  if (forecast_watcher_.isRunning()) {
+    return;
+  }
+
+  forecast_cancelled_ = false;
+  forecast_plot_ = plot;
+  forecast_ready_handler_ = on_ready;
+  SetForecastRunning(true);
+  forecast_watcher_.setFuture(QtConcurrent::run(forecast));
+}
+
+// plot limits cancelling to the forecast drawn on it, nullptr cancels any;
+// returns at once, the job stops at its next progress report and
+// OnForecastFinished drops its result
+void MainWindow::CancelForecast(QCustomPlot* plot) {
+  if (forecast_watcher_.isRunning() &&
+      (plot == nullptr || plot == forecast_plot_)) {
+    forecast_cancelled_ = true;
+  }
+}
+
+void MainWindow::OnForecastFinished() {
+  SetForecastRunning(false);
+  if (forecast_cancelled_) {
+    QString filename = pending_file_name_;
+    pending_file_name_.clear();
+    if (!filename.isEmpty()) {
+      LoadData(filename);
+    }
+    return;
+  }
+
+  if (forecast_watcher_.result()) {
+    (this->*forecast_ready_handler_)();
+  } else {
+    QMessageBox::critical(this, "Error",
+                          QString::fromStdString(model_->GetError()),
+                          QMessageBox::Ok);
+  }
+}
+
+void MainWindow::SetForecastRunning(bool running) {
+  ui_->forecastProgressBar->setValue(0);
+  ui_->forecastProgressBar->setVisible(running);
+
+  // controls that would use the model while the worker holds it
+  ui_->ipnForecastBtn->setDisabled(running);
+  ui_->apnForecastBtn->setDisabled(running);
+  ui_->apnSimulateBtn->setDisabled(running);
+  if (running) {
+    ui_->ipnDrawGraphBtn->setDisabled(true);
+    ui_->apnDrawGraphBtn->setDisabled(true);
+  } else {
+    ui_->ipnDrawGraphBtn->setEnabled(ui_->ipnPlot->graphCount() <
+                                     kMaxPlotsCount);
+    ui_->apnDrawGraphBtn->setEnabled(ui_->apnPlot->graphCount() <
+                                     kMaxPlotsCount + 1);
+  }
+}
+
 void MainWindow::InitPlot(QCustomPlot* plot) {
   plot->xAxis->setLabel("Date");
   plot->xAxis->setLabelFont(QFont(QFont().family(), 14, QFont::Bold));
@@ -116,10 +237,12 @@ void MainWindow::InitPlot(QCustomPlot* plot) {
 
   QSharedPointer<QCPAxisTickerDateTime> dateTicker(new QCPAxisTickerDateTime);
   dateTicker->setDateTimeFormat("d MMMM\nyyyy");
+  // the model dates are UTC midnights, as are those of the date boxes
+  dateTicker->setTimeZone(QTimeZone::utc());
   plot->xAxis->setTicker(dateTicker);
   plot->xAxis->setTickLabelFont(QFont(QFont().family(), 8));
 
-  QDateTime now = QDateTime::currentDateTime();
+  QDateTime now = QDateTime::currentDateTimeUtc();
   plot->xAxis->setRange(now.toSecsSinceEpoch(),
                         now.addDays(5).toSecsSinceEpoch());
 
@@ -130,27 +253,29 @@ void MainWindow::InitPlot(QCustomPlot* plot) {
 }
 
 void MainWindow::InitControlPanel() {
+  QDateTime max_date =
+      QDateTime::fromSecsSinceEpoch(model_->GetMaxDate(), QTimeZone::utc());
+  QDateTime min_date =
+      QDateTime::fromSecsSinceEpoch(model_->GetMinDate(), QTimeZone::utc());
+
   ui_->ipnPointsCountSpinBox->setMinimum(model_->GetData().size());
-  ui_->ipnDateBox->setMaximumDateTime(
-      QDateTime::fromSecsSinceEpoch(model_->GetMaxDate()));
-  ui_->ipnDateBox->setMinimumDateTime(
-      QDateTime::fromSecsSinceEpoch(model_->GetMinDate()));
+  ui_->ipnDateBox->setMaximumDateTime(max_date);
+  ui_->ipnDateBox->setMinimumDateTime(min_date);
   ui_->ipnForecastPriceBox->setValue(0);
 
   ui_->apnPointsCountSpinBox->setMinimum(model_->GetData().size());
   ui_->apnDateBox->setMaximumDateTime(
-      QDateTime::fromSecsSinceEpoch(model_->GetMaxDate())
-          .addDays(ui_->apnDaysCountSpinBox->maximum()));
-  ui_->apnDateBox->setMinimumDateTime(
-      QDateTime::fromSecsSinceEpoch(model_->GetMinDate()));
+      max_date.addDays(ui_->apnDaysCountSpinBox->maximum()));
+  ui_->apnDateBox->setMinimumDateTime(min_date);
   ui_->apnForecastPriceBox->setValue(0);
 }
 
 void MainWindow::DrawInterpolationGraph() {
+  size_t points_count = model_->GetForecast().size();
   ui_->ipnPlot->addGraph();
   PrepareGraph(ui_->ipnPlot, ui_->ipnPlot->graph(),
                ui_->ipnPlot->graphCount() + 6);
-  ShowLegendItem(ui_->ipnLegend, ui_->ipnPlot->graphCount());
+  ShowLegendItem(ui_->ipnLegend, ui_->ipnPlot->graphCount(), points_count);
   ui_->ipnPlot->replot();
 }
 
@@ -160,10 +285,38 @@ void MainWindow::DrawApproximationGraph() {
     PrepareDataSet(ui_->apnPlot, ui_->apnPlot->graph());
   }
 
+  size_t points_count = model_->GetForecast().size();
   ui_->apnPlot->addGraph();
   PrepareGraph(ui_->apnPlot, ui_->apnPlot->graph(),
                ui_->apnPlot->graphCount() + 5);
-  ShowLegendItem(ui_->apnLegend, ui_->apnPlot->graphCount() - 1);
+  ShowLegendItem(ui_->apnLegend, ui_->apnPlot->graphCount() - 1,
+                 points_count);
+  ui_->apnPlot->replot();
+}
+
+// curves rather than graphs, which the legend and its colors count
+void MainWindow::DrawSimulationBands() {
+  if (ui_->apnPlot->graphCount() == 0) {
+    ui_->apnPlot->addGraph();
+    PrepareDataSet(ui_->apnPlot, ui_->apnPlot->graph());
+  }
+
+  const std::vector<TimeSeries>& bands = model_->GetForecastBands();
+  const std::vector<double>& percentiles = simulation_settings_.percentiles;
+  for (size_t i = 0; i < bands.size(); ++i) {
+    const TimeSeries& band = bands[i];
+    QVector<double> keys(band.Dates().begin(), band.Dates().end());
+    QVector<double> values(band.Prices().begin(), band.Prices().end());
+
+    // the median solid, the other percentiles dashed
+    bool is_median = percentiles[i] == 50.0;
+    QCPCurve* curve = new QCPCurve(ui_->apnPlot->xAxis, ui_->apnPlot->yAxis);
+    curve->setData(keys, values);
+    curve->setPen(QPen(Qt::darkGray, is_median ? 2 : 1,
+                       is_median ? Qt::SolidLine : Qt::DashLine));
+    curve->rescaleAxes(true);
+  }
+
   ui_->apnPlot->replot();
 }
 
@@ -179,13 +332,8 @@ void MainWindow::PrepareDataSet(QCustomPlot* plot, QCPGraph* graph) {
   scatterStyle.setSize(8);           // Set the size of the scatter points
   graph->setScatterStyle(scatterStyle);
 
-  // set data
-  QVector<double> dates, prices;
-  for (auto& data_point : model_->GetData()) {
-    dates.push_back(data_point.date.ToDouble());
-    prices.push_back(data_point.price);
-  }
-  graph->setData(dates, prices);
+  // set data, resampled to the visible range on every replot
+  new GraphDecimator(graph, model_->GetData());
 
   // set axis ranges to show all data
   graph->rescaleAxes();
@@ -201,13 +349,9 @@ void MainWindow::PrepareGraph(QCustomPlot* plot, QCPGraph* graph,
   graph->setPen(QPen(Qt::GlobalColor(color_num), 2, Qt::SolidLine,
                      Qt::SquareCap, Qt::MiterJoin));
 
-  // set data
-  QVector<double> dates, prices;
-  for (auto& data_point : model_->GetForecast()) {
-    dates.push_back(data_point.date.ToDouble());
-    prices.push_back(data_point.price);
-  }
-  graph->setData(dates, prices);
+  // hand the forecast buffers over to the graph without copying them,
+  // resampled to the visible range on every replot
+  new GraphDecimator(graph, model_->TakeForecast());
 
   // set axis ranges to show all data
   if (plot->graphCount() == 1) {
@@ -221,7 +365,8 @@ void MainWindow::PrepareGraph(QCustomPlot* plot, QCPGraph* graph,
   }
 }
 
-void MainWindow::ShowLegendItem(QWidget* legend, int item_position) {
+void MainWindow::ShowLegendItem(QWidget* legend, int item_position,
+                                size_t points_count) {
   // find legend item
   QWidget* legend_item =
       static_cast<QWidget*>(legend->children().at(item_position));
@@ -237,7 +382,7 @@ void MainWindow::ShowLegendItem(QWidget* legend, int item_position) {
   QLabel* graph_name =
       legend_item->findChildren<QLabel*>(QRegularExpression("\\w{1,}Label$"))
           .first();
-  graph_name->setText(QString::number(model_->GetForecast().size()) + " pts");
+  graph_name->setText(QString::number(points_count) + " pts");
 
   // show item
   legend_item->setVisible(true);
@@ -1,10 +1,15 @@
 #ifndef ALGORITHMIC_TRADING_MAINWINDOW_H
 #define ALGORITHMIC_TRADING_MAINWINDOW_H
 
+#include <QFutureWatcher>
 #include <QMainWindow>
+#include <atomic>
+#include <functional>
+#include <memory>
 
 #include "../../libs/qcustomplot.h"
 #include "../model/stockforecaster.h"
+#include "graph_decimator.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -19,8 +24,12 @@ class MainWindow : public QMainWindow {
   MainWindow(QWidget* parent = nullptr);
   ~MainWindow();
 
+ signals:
+  void ForecastProgressChanged(int percent);
+
  private slots:
   void on_loadDataBtn_clicked();
+  void OnForecastFinished();
 
   // Interpolation
   void on_ipnDrawGraphBtn_clicked();
@@ -42,21 +51,45 @@ class MainWindow : public QMainWindow {
   void on_apnLegendGreenCheckBox_stateChanged(int state);
   void on_apnLegendRedCheckBox_stateChanged(int state);
   void on_apnDaysCountSpinBox_valueChanged();
+  void on_apnSimulateBtn_clicked();
 
  private:
   const int kMaxPlotsCount = 5;
 
+  void LoadData(const QString& filename);
   void InitPlot(QCustomPlot* plot);
   void InitControlPanel();
   void DrawInterpolationGraph();
   void DrawApproximationGraph();
+  void DrawSimulationBands();
   void PrepareGraph(QCustomPlot* plot, QCPGraph* graph, int colorNum);
   void PrepareDataSet(QCustomPlot* plot, QCPGraph* graph);
-  void ShowLegendItem(QWidget* legend, int item_position);
+  void ShowLegendItem(QWidget* legend, int item_position, size_t points_count);
   void HideLegend(QWidget* legend);
   void ChangeGraphVisibility(QCustomPlot* plot, int graph_number, bool visible);
 
+  // Background forecasts
+  void RunForecast(QCustomPlot* plot, const std::function<bool()>& forecast,
+                   void (MainWindow::*on_ready)());
+  void CancelForecast(QCustomPlot* plot = nullptr);
+  void SetForecastRunning(bool running);
+  void OnInterpolationReady();
+  void OnApproximationReady();
+  void OnSimulationReady();
+
   Ui::MainWindow* ui_;
   StockForecaster* model_;
+
+  // the model is used by at most one forecast job at a time
+  QFutureWatcher<bool> forecast_watcher_;
+  std::atomic<bool> forecast_cancelled_{false};
+  QCustomPlot* forecast_plot_ = nullptr;
+  void (MainWindow::*forecast_ready_handler_)() = nullptr;
+  QString pending_file_name_;  // chosen while a forecast was running
+
+  // the Monte Carlo paths, run from the forecast job; a band per percentile,
+  // and the threads started by the first simulation only
+  SimulationSettings simulation_settings_;
+  std::unique_ptr<ThreadPool> simulation_pool_;
 };
 #endif  // ALGORITHMIC_TRADING_MAINWINDOW_H
@@ -0,0 +1,64 @@
+#include "cubic_spline.h"
+
+#include "test_check.h"
+
+namespace {
+
+// every segment of the spline at its knot and halfway to the next one
+void CheckSameSpline(const CubicSpline& spline, const CubicSpline& expected,
+                     const TimeSeries& data, size_t knots_count) {
+  for (size_t i = 0; i < knots_count; ++i) {
+    time_t date = data.Dates()[i];
+    CHECK_NEAR(spline.InterpolatePrice(date, i),
+               expected.InterpolatePrice(date, i), 1e-12);
+    CHECK_NEAR(spline.InterpolatePrice(date + 43200, i),
+               expected.InterpolatePrice(date + 43200, i), 1e-9);
+  }
+}
+
+// Append refits only the last kTailSize knots, which must leave the same
+// spline as a fit over all of them
+void TestAppendMatchesRefit() {
+  const size_t kFirstCount = 20;
+  TimeSeries data = MakeRandomWalk(300, 1);
+  CubicSpline spline(data, 0, kFirstCount);
+  for (size_t count = kFirstCount + 1; count <= data.size(); ++count) {
+    spline.Append(data.Dates()[count - 1], data.Prices()[count - 1]);
+    if (count % 37 == 0 || count == data.size()) {
+      CheckSameSpline(spline, CubicSpline(data, 0, count), data, count);
+    }
+  }
+}
+
+// appended one by one from the first two points
+void TestAppendFromStart() {
+  TimeSeries data = MakeRandomWalk(100, 2);
+  CubicSpline spline(data, 0, 2);
+  for (size_t i = 2; i < data.size(); ++i) {
+    spline.Append(data.Dates()[i], data.Prices()[i]);
+  }
+  CheckSameSpline(spline, CubicSpline(data), data, data.size());
+}
+
+// past the last knot the spline goes on along its tangent
+void TestLinearExtrapolation() {
+  TimeSeries data = MakeRandomWalk(50, 3);
+  CubicSpline spline(data);
+  size_t last_idx = data.size() - 1;
+  time_t last_date = data.Dates()[last_idx];
+  double last_price = spline.InterpolatePrice(last_date, last_idx);
+  double step = spline.InterpolatePrice(last_date + 86400, last_idx) -
+                last_price;
+  CHECK_NEAR(last_price, data.Prices()[last_idx], 1e-12);
+  CHECK_NEAR(spline.InterpolatePrice(last_date + 10 * 86400, last_idx),
+             last_price + 10 * step, 1e-9);
+}
+
+}  // namespace
+
+int main() {
+  TestAppendMatchesRefit();
+  TestAppendFromStart();
+  TestLinearExtrapolation();
+  return ReportChecks();
+}
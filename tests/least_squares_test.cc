@@ -0,0 +1,114 @@
+#include "least_squares_polynomial.h"
+#include "recursive_least_squares.h"
+#include "rolling_least_squares.h"
+#include "test_check.h"
+
+namespace {
+
+TimeSeries Slice(const TimeSeries& data, size_t first_idx, size_t last_idx) {
+  TimeSeries slice;
+  for (size_t i = first_idx; i < last_idx; ++i) {
+    slice.Append(data.Dates()[i], data.Prices()[i]);
+  }
+
+  return slice;
+}
+
+// the recursive updates over all the bars end at the batch fit, up to the
+// vague prior they start from
+void TestRecursiveMatchesBatch() {
+  TimeSeries data = MakeRandomWalk(500, 4);
+  for (int degree : {1, 3, 6}) {
+    RecursiveLeastSquares trend(degree);
+    for (size_t i = 0; i < data.size(); ++i) {
+      trend.Update(data.Dates()[i], data.Prices()[i]);
+    }
+
+    LeastSquaresPolynomial batch(data, degree);
+    CHECK(trend.size() == data.size());
+    for (size_t i = 0; i < data.size(); i += 7) {
+      time_t date = data.Dates()[i];
+      CHECK_NEAR(trend.ApproximatePrice(date), batch.ApproximatePrice(date),
+                 1e-6);
+    }
+  }
+}
+
+// with a sliding window, the batch fit over the last window_size bars
+void TestRecursiveWindowMatchesBatch() {
+  const size_t kWindowSize = 60;
+  TimeSeries data = MakeRandomWalk(400, 5);
+  RecursiveLeastSquares trend(4, 1.0, kWindowSize);
+  for (size_t i = 0; i < data.size(); ++i) {
+    trend.Update(data.Dates()[i], data.Prices()[i]);
+    if (i + 1 < kWindowSize || (i + 1) % 50 != 0) {
+      continue;
+    }
+
+    CHECK(trend.size() == kWindowSize);
+    LeastSquaresPolynomial batch(Slice(data, i + 1 - kWindowSize, i + 1), 4);
+    for (size_t j = i + 1 - kWindowSize; j <= i; j += 5) {
+      time_t date = data.Dates()[j];
+      CHECK_NEAR(trend.ApproximatePrice(date), batch.ApproximatePrice(date),
+                 1e-6);
+    }
+  }
+}
+
+// the window slides through several rebases of the normalization
+void TestRollingMatchesBatch() {
+  const size_t kWindowSize = 40;
+  TimeSeries data = MakeRandomWalk(300, 6);
+  RollingLeastSquares polynomial(data, 5);
+  for (size_t i = 0; i < kWindowSize; ++i) {
+    polynomial.PushBack();
+  }
+
+  for (size_t first_idx = 0; first_idx + kWindowSize <= data.size();
+       ++first_idx) {
+    if (first_idx > 0) {
+      polynomial.PopFront();
+      polynomial.PushBack();
+    }
+    if (first_idx % 23 != 0) {
+      continue;
+    }
+
+    LeastSquaresPolynomial batch(
+        Slice(data, first_idx, first_idx + kWindowSize), 5);
+    time_t next_date = data.Dates()[first_idx + kWindowSize - 1] + 86400;
+    CHECK_NEAR(polynomial.ApproximatePrice(next_date),
+               batch.ApproximatePrice(next_date), 1e-8);
+  }
+}
+
+// every degree of FitDegrees is the batch fit of that degree
+void TestRollingDegreesMatchBatch() {
+  const int kMaxDegree = 8;
+  TimeSeries data = MakeRandomWalk(120, 7);
+  RollingLeastSquares polynomial(data, kMaxDegree);
+  for (size_t i = 0; i < data.size(); ++i) {
+    polynomial.PushBack();
+  }
+
+  Matrix fits;
+  CHECK(polynomial.FitDegrees(fits) == kMaxDegree + 1);
+  for (int degree = 0; degree <= kMaxDegree; ++degree) {
+    LeastSquaresPolynomial batch(data, degree);
+    for (size_t i = 0; i < data.size(); i += 11) {
+      time_t date = data.Dates()[i];
+      CHECK_NEAR(polynomial.ApproximatePrice(fits, degree, date),
+                 batch.ApproximatePrice(date), 1e-8);
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  TestRecursiveMatchesBatch();
+  TestRecursiveWindowMatchesBatch();
+  TestRollingMatchesBatch();
+  TestRollingDegreesMatchBatch();
+  return ReportChecks();
+}
@@ -0,0 +1,164 @@
+#include "lu_decomposition.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "chebyshev.h"
+#include "least_squares_polynomial.h"
+#include "test_check.h"
+
+namespace {
+
+ScratchMatrix MakeMatrix(const std::vector<std::vector<double>>& rows) {
+  ScratchMatrix matrix(rows.size(), rows.size());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    for (size_t j = 0; j < rows.size(); ++j) {
+      matrix[i][j] = rows[i][j];
+    }
+  }
+
+  return matrix;
+}
+
+// the zero first pivot needs a row swap
+void TestSolveKnownSystem() {
+  ScratchArena::Scope scope;
+  ScratchMatrix matrix = MakeMatrix({{0, 1, 1}, {4, -6, 0}, {-2, 7, 2}});
+  LuDecomposition lu(matrix);
+  CHECK(!lu.IsSingular());
+
+  // A * (1, 1, 2) and A^T * (1, 2, 3)
+  double rhs[] = {3, -2, 9};
+  lu.Solve(rhs);
+  CHECK_NEAR(rhs[0], 1.0, 1e-14);
+  CHECK_NEAR(rhs[1], 1.0, 1e-14);
+  CHECK_NEAR(rhs[2], 2.0, 1e-14);
+
+  double transposed_rhs[] = {2, 10, 7};
+  lu.SolveTransposed(transposed_rhs);
+  CHECK_NEAR(transposed_rhs[0], 1.0, 1e-14);
+  CHECK_NEAR(transposed_rhs[1], 2.0, 1e-14);
+  CHECK_NEAR(transposed_rhs[2], 3.0, 1e-14);
+}
+
+// ||A|| = 6 and A^-1 = ((-2, 1), (1.5, -0.5)), ||A^-1|| = 3.5
+void TestConditionOfKnownMatrix() {
+  ScratchArena::Scope scope;
+  ScratchMatrix matrix = MakeMatrix({{1, 2}, {3, 4}});
+  LuDecomposition lu(matrix);
+  CHECK_NEAR(lu.GetConditionNumber(), 21.0, 1e-12);
+}
+
+// the second difference matrix tridiag(-1, 2, -1) of order n, whose inverse
+// is min(i, j) * (n + 1 - max(i, j)) / (n + 1) with one-based indices; it
+// spans several blocks of the factorization
+void TestConditionOfSecondDifference() {
+  const size_t kSize = 100;
+  ScratchArena::Scope scope;
+  ScratchMatrix matrix(kSize, kSize);
+  for (size_t i = 0; i < kSize; ++i) {
+    matrix[i][i] = 2.0;
+    if (i > 0) {
+      matrix[i][i - 1] = matrix[i - 1][i] = -1.0;
+    }
+  }
+
+  double inverse_norm = 0.0;
+  for (size_t j = 1; j <= kSize; ++j) {
+    double column_norm = 0.0;
+    for (size_t i = 1; i <= kSize; ++i) {
+      column_norm += static_cast<double>(std::min(i, j)) *
+                     (kSize + 1 - std::max(i, j)) / (kSize + 1);
+    }
+    inverse_norm = std::max(inverse_norm, column_norm);
+  }
+
+  LuDecomposition lu(matrix);
+  CHECK_NEAR(lu.GetConditionNumber(), 4.0 * inverse_norm, 1e-10);
+}
+
+// a random system of several blocks solved against its known solution
+void TestSolveBlockedSystem() {
+  const size_t kSize = 3 * LuDecomposition::kBlockSize + 5;
+  std::mt19937_64 generator(9);
+  std::uniform_real_distribution<double> value(-1.0, 1.0);
+  ScratchArena::Scope scope;
+  ScratchMatrix matrix(kSize, kSize);
+  std::vector<double> solution(kSize);
+  for (size_t i = 0; i < kSize; ++i) {
+    solution[i] = value(generator);
+    for (size_t j = 0; j < kSize; ++j) {
+      matrix[i][j] = value(generator);
+    }
+  }
+
+  std::vector<double> rhs(kSize, 0.0), transposed_rhs(kSize, 0.0);
+  for (size_t i = 0; i < kSize; ++i) {
+    for (size_t j = 0; j < kSize; ++j) {
+      rhs[i] += matrix[i][j] * solution[j];
+      transposed_rhs[i] += matrix[j][i] * solution[j];
+    }
+  }
+
+  LuDecomposition lu(matrix);
+  lu.Solve(rhs.data());
+  lu.SolveTransposed(transposed_rhs.data());
+  double condition_number = lu.GetConditionNumber();
+  CHECK(condition_number > 1.0 && condition_number < 1e6);
+  for (size_t i = 0; i < kSize; ++i) {
+    CHECK_NEAR(rhs[i], solution[i], 1e-10);
+    CHECK_NEAR(transposed_rhs[i], solution[i], 1e-10);
+  }
+}
+
+void TestSingularMatrix() {
+  ScratchArena::Scope scope;
+  ScratchMatrix matrix = MakeMatrix({{1, 2, 3}, {2, 4, 6}, {1, 0, 1}});
+  LuDecomposition lu(matrix);
+  CHECK(lu.IsSingular());
+  CHECK(lu.GetConditionNumber() == std::numeric_limits<double>::infinity());
+}
+
+// a polynomial of degree 30 is recovered from its values, with the
+// condition estimate of the Chebyshev normal equations it was solved from
+void TestPolynomialOfDegree30() {
+  const int kDegree = 30;
+  std::vector<double> coeffs(kDegree + 1);
+  for (int k = 0; k <= kDegree; ++k) {
+    coeffs[k] = 100.0 / (k + 1) * (k % 2 == 0 ? 1.0 : -1.0);
+  }
+
+  // 500 days, so the dates normalize to [-1, 1] by x = (day - 249.5) / 249.5
+  TimeSeries data;
+  const time_t kFirstDate = 1262304000;
+  for (int day = 0; day < 500; ++day) {
+    data.Append(kFirstDate + day * 86400,
+                SumChebyshevSeries(coeffs, (day - 249.5) / 249.5));
+  }
+
+  LeastSquaresPolynomial polynomial(data, kDegree);
+  CHECK(polynomial.GetDegree() == kDegree);
+  CHECK(polynomial.GetConditionNumber() < 100.0);
+  for (double day = 0.25; day < 499; day += 3.5) {
+    time_t date = kFirstDate + static_cast<time_t>(day * 86400);
+    CHECK_NEAR(polynomial.ApproximatePrice(date),
+               SumChebyshevSeries(coeffs, (day - 249.5) / 249.5), 1e-9);
+  }
+
+  // and fewer points than the degree needs define a lower one
+  CHECK(LeastSquaresPolynomial(data, 600).GetDegree() == 499);
+}
+
+}  // namespace
+
+int main() {
+  TestSolveKnownSystem();
+  TestConditionOfKnownMatrix();
+  TestConditionOfSecondDifference();
+  TestSolveBlockedSystem();
+  TestSingularMatrix();
+  TestPolynomialOfDegree30();
+  return ReportChecks();
+}
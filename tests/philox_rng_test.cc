@@ -0,0 +1,42 @@
+#include "philox_rng.h"
+
+#include "test_check.h"
+
+namespace {
+
+// the known-answer vectors of Philox4x32-10 published with Random123
+void TestKnownAnswers() {
+  struct KnownAnswer {
+    uint64_t seed;  // key[1] in the high word
+    PhiloxRng::Counter counter;
+    PhiloxRng::Counter expected;
+  };
+  const KnownAnswer kKnownAnswers[] = {
+      {0, {0, 0, 0, 0}, {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+      {0xffffffffffffffffULL,
+       {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+       {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+      {0x299f31d0a4093822ULL,
+       {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+       {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}},
+  };
+
+  for (const KnownAnswer& known_answer : kKnownAnswers) {
+    PhiloxRng rng(known_answer.seed);
+    CHECK(rng(known_answer.counter) == known_answer.expected);
+  }
+}
+
+void TestUniformBounds() {
+  CHECK(PhiloxRng::ToUniform(0, 0) == 0.0);
+  CHECK(PhiloxRng::ToUniform(0xffffffff, 0xffffffff) < 1.0);
+  CHECK(PhiloxRng::ToUniform(0x80000000, 0) == 0.5);
+}
+
+}  // namespace
+
+int main() {
+  TestKnownAnswers();
+  TestUniformBounds();
+  return ReportChecks();
+}
@@ -0,0 +1,108 @@
+#include "series_cache.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "test_check.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// the cache only looks at the size and the modification time of the CSV,
+// so any text stands for it
+void WriteText(const fs::path& path, const std::string& text) {
+  std::ofstream ofs(path, std::ios::binary);
+  ofs << text;
+}
+
+bool IsSameSeries(const TimeSeries& series, const TimeSeries& expected) {
+  return series.Dates() == expected.Dates() &&
+         series.Prices() == expected.Prices();
+}
+
+// gaps of a second to years, which take from one to several varint bytes
+TimeSeries MakeIrregularSeries() {
+  TimeSeries series = MakeRandomWalk(1000, 8);
+  TimeSeries irregular;
+  time_t date = -86400 * 365;
+  for (size_t i = 0; i < series.size(); ++i) {
+    date += i % 7 == 0 ? 1 : i % 11 == 0 ? 86400 * 800 : 60 * (i % 5 + 1);
+    irregular.Append(date, series.Prices()[i]);
+  }
+
+  return irregular;
+}
+
+void TestRoundTrip(const fs::path& csv_path) {
+  WriteText(csv_path, "Date,Close\n");
+  TimeSeries series = MakeIrregularSeries();
+  CHECK(SeriesCache(csv_path.string()).Save(series));
+
+  TimeSeries loaded;
+  CHECK(SeriesCache(csv_path.string()).Load(loaded));
+  CHECK(IsSameSeries(loaded, series));
+
+  TimeSeries empty;
+  CHECK(SeriesCache(csv_path.string()).Save(empty));
+  loaded = series;
+  CHECK(SeriesCache(csv_path.string()).Load(loaded));
+  CHECK(loaded.empty());
+}
+
+// a CSV of another size or modification time, or a damaged cache, makes
+// Load fail and leave the data as it was
+void TestInvalidation(const fs::path& csv_path) {
+  TimeSeries series = MakeIrregularSeries();
+  WriteText(csv_path, "Date,Close\n");
+  SeriesCache cache(csv_path.string());
+  CHECK(cache.Save(series));
+  const std::string& cache_path = cache.GetPath();
+
+  TimeSeries loaded;
+  WriteText(csv_path, "Date,Close\n2023-01-05,1\n");
+  CHECK(!SeriesCache(csv_path.string()).Load(loaded));
+  CHECK(loaded.empty());
+
+  WriteText(csv_path, "Date,Close\n");
+  CHECK(SeriesCache(csv_path.string()).Save(series));
+  fs::last_write_time(csv_path,
+                      fs::last_write_time(csv_path) + std::chrono::hours(1));
+  CHECK(!SeriesCache(csv_path.string()).Load(loaded));
+
+  CHECK(SeriesCache(csv_path.string()).Save(series));
+  CHECK(SeriesCache(csv_path.string()).Load(loaded));
+  uintmax_t cache_size = fs::file_size(cache_path);
+  {
+    std::fstream file(cache_path,
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(cache_size / 2);
+    file.put('\x5a');
+  }
+  loaded = TimeSeries();
+  CHECK(!SeriesCache(csv_path.string()).Load(loaded));
+
+  CHECK(SeriesCache(csv_path.string()).Save(series));
+  fs::resize_file(cache_path, cache_size - 1);
+  CHECK(!SeriesCache(csv_path.string()).Load(loaded));
+  CHECK(loaded.empty());
+
+  fs::remove(csv_path);
+  CHECK(!SeriesCache(csv_path.string()).Load(loaded));
+  CHECK(!SeriesCache(csv_path.string()).Save(series));
+  fs::remove(cache_path);
+}
+
+}  // namespace
+
+int main() {
+  auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+  fs::path dir = fs::temp_directory_path() /
+                 ("series_cache_test_" + std::to_string(now));
+  fs::create_directories(dir);
+  TestRoundTrip(dir / "round_trip.csv");
+  TestInvalidation(dir / "invalidation.csv");
+  fs::remove_all(dir);
+  return ReportChecks();
+}
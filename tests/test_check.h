@@ -0,0 +1,69 @@
+#ifndef ALGORITHMIC_TRADING_TESTS_TESTCHECK_H
+#define ALGORITHMIC_TRADING_TESTS_TESTCHECK_H
+
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "time_series.h"
+
+// Checks of the unit tests: a failed one prints where and what, and the test
+// goes on, so a run reports every failure at once. main returns
+// ReportChecks(), which ctest reads as the result.
+
+inline int& GetFailuresCount() {
+  static int failures_count = 0;
+  return failures_count;
+}
+
+inline void CheckThat(bool condition, const char* text, const char* file,
+                      int line) {
+  if (!condition) {
+    std::cerr << file << ':' << line << ": check failed: " << text << '\n';
+    ++GetFailuresCount();
+  }
+}
+
+// within tolerance relative to the larger of 1 and |expected|
+inline void CheckNear(double actual, double expected, double tolerance,
+                      const char* text, const char* file, int line) {
+  double scale = std::fmax(1.0, std::fabs(expected));
+  if (!(std::fabs(actual - expected) <= tolerance * scale)) {
+    std::cerr << file << ':' << line << ": " << text << " is " << actual
+              << ", expected " << expected << '\n';
+    ++GetFailuresCount();
+  }
+}
+
+#define CHECK(condition) CheckThat((condition), #condition, __FILE__, __LINE__)
+#define CHECK_NEAR(actual, expected, tolerance) \
+  CheckNear((actual), (expected), (tolerance), #actual, __FILE__, __LINE__)
+
+inline int ReportChecks() {
+  if (GetFailuresCount() > 0) {
+    std::cerr << GetFailuresCount() << " checks failed\n";
+    return 1;
+  }
+
+  return 0;
+}
+
+// daily prices of a random walk, the same for a seed
+inline TimeSeries MakeRandomWalk(size_t size, unsigned seed) {
+  std::mt19937_64 generator(seed);
+  std::normal_distribution<double> step(0.0, 1.0);
+
+  TimeSeries series;
+  series.Reserve(size);
+  time_t date = 1262304000;  // 2010-01-01
+  double price = 100.0;
+  for (size_t i = 0; i < size; ++i) {
+    series.Append(date, price);
+    date += 86400;
+    price += step(generator);
+  }
+
+  return series;
+}
+
+#endif  // ALGORITHMIC_TRADING_TESTS_TESTCHECK_H
@@ -0,0 +1,76 @@
+#include "time_point.h"
+
+#include "test_check.h"
+
+namespace {
+
+static_assert(TimePoint::DaysFromCivil(1970, 1, 1) == 0);
+static_assert(TimePoint::DaysFromCivil(2000, 3, 1) == 11017);
+static_assert(TimePoint::DaysFromCivil(1969, 12, 31) == -1);
+
+const time_t kSecondsPerDay = 24 * 60 * 60;
+
+// every day of about 1680 to 2260 back and forth through the civil date,
+// which must step through the calendar one day at a time
+void TestCivilFromDaysRoundTrip() {
+  const long long kFirstDays = -106000;
+  int prev_year;
+  unsigned prev_month, prev_day;
+  TimePoint::CivilFromDays(kFirstDays - 1, prev_year, prev_month, prev_day);
+  for (long long days = kFirstDays; days < -kFirstDays; ++days) {
+    int year;
+    unsigned month, day;
+    TimePoint::CivilFromDays(days, year, month, day);
+    CHECK(TimePoint::DaysFromCivil(year, month, day) == days);
+
+    bool is_next_day = year == prev_year && month == prev_month &&
+                       day == prev_day + 1;
+    bool is_next_month = year == prev_year && month == prev_month + 1 &&
+                         day == 1;
+    bool is_next_year = year == prev_year + 1 && month == 1 && day == 1 &&
+                        prev_month == 12 && prev_day == 31;
+    CHECK(is_next_day || is_next_month || is_next_year);
+    prev_year = year;
+    prev_month = month;
+    prev_day = day;
+  }
+}
+
+// formatted and parsed back, any time of a day gives its midnight
+void TestStringRoundTrip() {
+  for (long long days = -106000; days < 106000; days += 13) {
+    for (time_t seconds : {time_t(0), time_t(13 * 3600), kSecondsPerDay - 1}) {
+      TimePoint time_point(days * kSecondsPerDay + seconds);
+      std::string text = time_point.ToString();
+      TimePoint parsed = TimePoint::FromChars(text.data(),
+                                              text.data() + text.size());
+      CHECK(parsed.isValid());
+      CHECK(parsed.ToTime_t() == days * kSecondsPerDay);
+    }
+  }
+}
+
+void TestParsing() {
+  CHECK(TimePoint("2023-01-05").ToString() == "2023-01-05");
+  CHECK(TimePoint("2023-01-05").ToTime_t() == 1672876800);
+  CHECK(TimePoint("2024-02-29").isValid());
+  CHECK(TimePoint("2000-02-29").isValid());
+  CHECK(TimePoint(-1).ToString() == "1969-12-31");
+  CHECK(TimePoint(-1).AddDays(1) == kSecondsPerDay - 1);
+
+  for (const char* text : {"2023-02-29", "1900-02-29", "2023-13-01",
+                           "2023-00-10", "2023-04-31", "2023-1-5x", "",
+                           "2023/01/05", "2023-01-05 "}) {
+    CHECK(!TimePoint(text).isValid());
+  }
+  CHECK(TimePoint("2023-1-5").ToString() == "2023-01-05");
+}
+
+}  // namespace
+
+int main() {
+  TestCivilFromDaysRoundTrip();
+  TestStringRoundTrip();
+  TestParsing();
+  return ReportChecks();
+}